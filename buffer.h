@@ -36,17 +36,48 @@ struct DeviceBufferAppend
 
 /// Utils
 ////////////////////////////////////////////////////////////
-static void ValidateBuffer(ResourceGroup* res_group, uint32 buffer_index, const char* action)
+static ResourceMemory* GetBufferResourceMemory(ResourceGroup* res_group, uint32 buffer_index)
+{
+    return GetResourceMemory(res_group, GetBufferState(res_group, buffer_index)->res_mem_index);
+}
+
+// Validates write and returns its region in the buffers returned by GetBuffer().
+static VkBufferCopy GetDeviceBufferWriteCopy(ResourceGroup* res_group, DeviceBufferWrite* write, uint32 frame_index)
 {
-    if (buffer_index >= res_group->buffer_count)
+    ValidateBuffer(res_group, write->src_hnd, "can't write from source buffer to destination device buffer");
+    ValidateBuffer(res_group, write->dst_hnd, "can't write to destination device buffer");
+    CTK_ASSERT(frame_index < res_group->frame_count);
+
+    BufferInfo* dst_info = GetBufferInfo(res_group, write->dst_hnd.index);
+    if (write->dst_offset + write->size > dst_info->size)
     {
-        CTK_FATAL("%s: buffer index %u exceeds buffer count of %u", action, buffer_index, res_group->buffer_count);
+        CTK_FATAL("can't write %u bytes to device buffer at offset %u: write would exceed size of %u",
+                  write->size, write->dst_offset, dst_info->size);
     }
+
+    BufferFrameState* dst_frame_state = GetBufferFrameState(res_group, write->dst_hnd.index, frame_index);
+    BufferFrameState* src_frame_state = GetBufferFrameState(res_group, write->src_hnd.index, frame_index);
+    VkBufferCopy copy =
+    {
+        .srcOffset = src_frame_state->res_mem_offset + write->src_offset,
+        .dstOffset = dst_frame_state->res_mem_offset + write->dst_offset,
+        .size      = write->size,
+    };
+    return copy;
 }
 
-static ResourceMemory* GetBufferResourceMemory(ResourceGroup* res_group, uint32 buffer_index)
+// Uncached host visible memory is usually write-combined, so it's written with streaming stores; cached memory is
+// written normally so writes stay in cache for later host reads.
+static void CopyToMappedMemory(ResourceMemory* res_mem, uint8* dst, uint8* src, VkDeviceSize size)
 {
-    return GetResourceMemory(res_group, GetBufferState(res_group, buffer_index)->res_mem_index);
+    if (res_mem->properties & VK_MEMORY_PROPERTY_HOST_CACHED_BIT)
+    {
+        memcpy(dst, src, size);
+    }
+    else
+    {
+        StreamCopy(dst, src, size);
+    }
 }
 
 /// Interface
@@ -54,7 +85,7 @@ static ResourceMemory* GetBufferResourceMemory(ResourceGroup* res_group, uint32
 static void WriteHostBuffer(HostBufferWrite* write, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(write->dst_hnd.group_index);
-    ValidateBuffer(res_group, write->dst_hnd.index, "can't write to destination host buffer");
+    ValidateBuffer(res_group, write->dst_hnd, "can't write to destination host buffer");
     CTK_ASSERT(frame_index < res_group->frame_count);
 
     BufferInfo*       dst_info        = GetBufferInfo      (res_group, write->dst_hnd.index);
@@ -68,15 +99,18 @@ static void WriteHostBuffer(HostBufferWrite* write, uint32 frame_index)
     ResourceMemory* res_mem = GetBufferResourceMemory(res_group, write->dst_hnd.index);
     CTK_ASSERT(res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 
-    uint8* dst = &res_mem->mapped[dst_frame_state->res_mem_offset + write->dst_offset];
+    uint8* mapped = GetBufferMappedMemory(res_group, write->dst_hnd.index);
+    uint8* dst = &mapped[dst_frame_state->res_mem_offset + write->dst_offset];
     uint8* src = &write->src_data[write->src_offset];
-    memcpy(dst, src, write->size);
+    CopyToMappedMemory(res_mem, dst, src, write->size);
+    MarkBufferWritten(res_group, write->dst_hnd.index, dst_frame_state->res_mem_offset + write->dst_offset,
+                      write->size);
 }
 
 static void AppendHostBuffer(HostBufferAppend* append, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(append->dst_hnd.group_index);
-    ValidateBuffer(res_group, append->dst_hnd.index, "can't append to destination host buffer");
+    ValidateBuffer(res_group, append->dst_hnd, "can't append to destination host buffer");
     CTK_ASSERT(frame_index < res_group->frame_count);
 
     BufferInfo*       dst_info        = GetBufferInfo      (res_group, append->dst_hnd.index);
@@ -90,45 +124,35 @@ static void AppendHostBuffer(HostBufferAppend* append, uint32 frame_index)
     ResourceMemory* res_mem = GetBufferResourceMemory(res_group, append->dst_hnd.index);
     CTK_ASSERT(res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 
-    uint8* dst = &res_mem->mapped[dst_frame_state->res_mem_offset + dst_frame_state->index];
+    uint8* mapped = GetBufferMappedMemory(res_group, append->dst_hnd.index);
+    uint8* dst = &mapped[dst_frame_state->res_mem_offset + dst_frame_state->index];
     uint8* src = &append->src_data[append->src_offset];
-    memcpy(dst, src, append->size);
+    CopyToMappedMemory(res_mem, dst, src, append->size);
+    MarkBufferWritten(res_group, append->dst_hnd.index, dst_frame_state->res_mem_offset + dst_frame_state->index,
+                      append->size);
     dst_frame_state->index += append->size;
 }
 
-static void WriteDeviceBufferCmd(DeviceBufferWrite* write, uint32 frame_index)
+static void WriteDeviceBufferCmd(VkCommandBuffer command_buffer, DeviceBufferWrite* write, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(write->dst_hnd.group_index);
-    ValidateBuffer(res_group, write->src_hnd.index, "can't write from source buffer to destination device buffer");
-    ValidateBuffer(res_group, write->dst_hnd.index, "can't write to destination device buffer");
-    CTK_ASSERT(frame_index < res_group->frame_count);
-
-    BufferInfo* dst_info = GetBufferInfo(res_group, write->dst_hnd.index);
-    if (write->dst_offset + write->size > dst_info->size)
-    {
-        CTK_FATAL("can't write %u bytes to device buffer at offset %u: write would exceed size of %u",
-                  write->size, write->dst_offset, dst_info->size);
-    }
-
-    BufferFrameState* dst_frame_state = GetBufferFrameState(res_group, write->dst_hnd.index, frame_index);
-    BufferFrameState* src_frame_state = GetBufferFrameState(res_group, write->src_hnd.index, frame_index);
-    VkBufferCopy copy =
-    {
-        .srcOffset = src_frame_state->res_mem_offset + write->src_offset,
-        .dstOffset = dst_frame_state->res_mem_offset + write->dst_offset,
-        .size      = write->size,
-    };
-    vkCmdCopyBuffer(GetTempCommandBuffer(),
+    VkBufferCopy copy = GetDeviceBufferWriteCopy(res_group, write, frame_index);
+    vkCmdCopyBuffer(command_buffer,
                     GetBuffer(res_group, write->src_hnd.index),
                     GetBuffer(res_group, write->dst_hnd.index),
                     1, &copy);
 }
 
+static void WriteDeviceBufferCmd(DeviceBufferWrite* write, uint32 frame_index)
+{
+    WriteDeviceBufferCmd(GetTempCommandBuffer(), write, frame_index);
+}
+
 static void AppendDeviceBufferCmd(DeviceBufferAppend* append, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(append->dst_hnd.group_index);
-    ValidateBuffer(res_group, append->src_hnd.index, "can't append from source buffer to destination device buffer");
-    ValidateBuffer(res_group, append->dst_hnd.index, "can't append to destination device buffer");
+    ValidateBuffer(res_group, append->src_hnd, "can't append from source buffer to destination device buffer");
+    ValidateBuffer(res_group, append->dst_hnd, "can't append to destination device buffer");
     CTK_ASSERT(frame_index < res_group->frame_count);
 
     BufferInfo* dst_info = GetBufferInfo(res_group, append->dst_hnd.index);
@@ -156,7 +180,7 @@ static void AppendDeviceBufferCmd(DeviceBufferAppend* append, uint32 frame_index
 static void Clear(BufferHnd buffer_hnd)
 {
     ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
-    ValidateBuffer(res_group, buffer_hnd.index, "can't clear buffer");
+    ValidateBuffer(res_group, buffer_hnd, "can't clear buffer");
 
     for (uint32 frame_index = 0; frame_index < GetBufferState(res_group, buffer_hnd.index)->frame_count; ++frame_index)
     {
@@ -167,42 +191,116 @@ static void Clear(BufferHnd buffer_hnd)
 static BufferInfo* GetBufferInfo(BufferHnd buffer_hnd)
 {
     ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
-    ValidateBuffer(res_group, buffer_hnd.index, "can't get buffer info");
+    ValidateBuffer(res_group, buffer_hnd, "can't get buffer info");
     return GetBufferInfo(res_group, buffer_hnd.index);
 }
 
 static BufferState* GetBufferState(BufferHnd buffer_hnd)
 {
     ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
-    ValidateBuffer(res_group, buffer_hnd.index, "can't get buffer state");
+    ValidateBuffer(res_group, buffer_hnd, "can't get buffer state");
     return GetBufferState(res_group, buffer_hnd.index);
 }
 
 static BufferFrameState* GetBufferFrameState(BufferHnd buffer_hnd, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
-    ValidateBuffer(res_group, buffer_hnd.index, "can't get buffer frame state");
+    ValidateBuffer(res_group, buffer_hnd, "can't get buffer frame state");
     CTK_ASSERT(frame_index < res_group->frame_count);
 
     return GetBufferFrameState(res_group, buffer_hnd.index, frame_index);
 }
 
+// Writes made through returned pointer to non-coherent memory must be followed by MarkHostBufferWritten(), and reads
+// of device writes preceded by InvalidateHostBuffer().
 template<typename Type>
 static Type* GetMappedMemory(BufferHnd buffer_hnd, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
-    ValidateBuffer(res_group, buffer_hnd.index, "can't get buffer mapped memory");
+    ValidateBuffer(res_group, buffer_hnd, "can't get buffer mapped memory");
     CTK_ASSERT(frame_index < res_group->frame_count);
 
     ResourceMemory* res_mem = GetBufferResourceMemory(res_group, buffer_hnd.index);
     CTK_ASSERT(res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
 
-    return (Type*)&res_mem->mapped[GetBufferFrameState(res_group, buffer_hnd.index, frame_index)->res_mem_offset];
+    uint8* mapped = GetBufferMappedMemory(res_group, buffer_hnd.index);
+    return (Type*)&mapped[GetBufferFrameState(res_group, buffer_hnd.index, frame_index)->res_mem_offset];
 }
 
 static VkBuffer GetBuffer(BufferHnd buffer_hnd)
 {
     ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
-    ValidateBuffer(res_group, buffer_hnd.index, "can't get buffer memory handle");
+    ValidateBuffer(res_group, buffer_hnd, "can't get buffer memory handle");
     return GetBuffer(res_group, buffer_hnd.index);
 }
+
+// GPU pointer to buffer's frame range, e.g. for passing per-draw data or vertex pulling through push constants instead
+// of descriptors. Changes if buffer is moved by the defragmenter, so fetch it each frame rather than caching it.
+static VkDeviceAddress GetBufferDeviceAddress(BufferHnd buffer_hnd, uint32 frame_index)
+{
+    ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
+    ValidateBuffer(res_group, buffer_hnd, "can't get buffer device address");
+    CTK_ASSERT(frame_index < res_group->frame_count);
+
+    return GetBufferBaseDeviceAddress(res_group, buffer_hnd.index) +
+           GetBufferFrameState(res_group, buffer_hnd.index, frame_index)->res_mem_offset;
+}
+
+// True if buffer can be written directly with WriteHostBuffer() instead of through a staging buffer, e.g. device
+// local buffers placed in device local host visible memory.
+static bool IsHostWritable(BufferHnd buffer_hnd)
+{
+    ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
+    ValidateBuffer(res_group, buffer_hnd, "can't check if buffer is host writable");
+    return GetBufferResourceMemory(res_group, buffer_hnd.index)->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+
+static void MarkHostBufferWritten(BufferHnd buffer_hnd, uint32 frame_index)
+{
+    ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
+    ValidateBuffer(res_group, buffer_hnd, "can't mark host buffer written");
+    CTK_ASSERT(frame_index < res_group->frame_count);
+
+    MarkBufferWritten(res_group, buffer_hnd.index,
+                      GetBufferFrameState(res_group, buffer_hnd.index, frame_index)->res_mem_offset,
+                      GetBufferState(res_group, buffer_hnd.index)->size);
+}
+
+// Makes device writes to buffers' frame ranges visible to the host with a single vkInvalidateMappedMemoryRanges() call
+// per batch. Commands writing buffers must have completed. Coherent buffers are skipped.
+static void InvalidateHostBuffers(BufferHnd* buffer_hnds, uint32 buffer_count, uint32 frame_index)
+{
+    FArray<VkMappedMemoryRange, MAX_MAPPED_RANGE_BATCH> ranges = {};
+    for (uint32 i = 0; i < buffer_count; ++i)
+    {
+        BufferHnd buffer_hnd = buffer_hnds[i];
+        ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
+        ValidateBuffer(res_group, buffer_hnd, "can't invalidate host buffer");
+        CTK_ASSERT(frame_index < res_group->frame_count);
+        if (!IsHostNonCoherent(res_group, buffer_hnd.index))
+        {
+            continue;
+        }
+
+        if (ranges.count == MAX_MAPPED_RANGE_BATCH)
+        {
+            VkResult res = vkInvalidateMappedMemoryRanges(GetDevice(), ranges.count, ranges.data);
+            Validate(res, "vkInvalidateMappedMemoryRanges() failed");
+            ranges.count = 0;
+        }
+        VkDeviceSize offset = GetBufferFrameState(res_group, buffer_hnd.index, frame_index)->res_mem_offset;
+        VkDeviceSize size = GetBufferState(res_group, buffer_hnd.index)->size;
+        Push(&ranges, GetBufferMappedRange(res_group, buffer_hnd.index, offset, size));
+    }
+
+    if (ranges.count > 0)
+    {
+        VkResult res = vkInvalidateMappedMemoryRanges(GetDevice(), ranges.count, ranges.data);
+        Validate(res, "vkInvalidateMappedMemoryRanges() failed");
+    }
+}
+
+static void InvalidateHostBuffer(BufferHnd buffer_hnd, uint32 frame_index)
+{
+    InvalidateHostBuffers(&buffer_hnd, 1, frame_index);
+}
@@ -12,6 +12,7 @@
 static constexpr uint32 UNSET_INDEX         = UINT32_MAX;
 static constexpr uint32 MAX_DEVICE_FEATURES = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
 static constexpr uint32 MAX_FRAME_COUNT     = 4;
+static constexpr uint32 MAX_RETIRED         = 256;
 
 struct InstanceInfo
 {
@@ -23,24 +24,51 @@ struct InstanceInfo
     VkDebugUtilsMessageTypeFlagsEXT     debug_message_type;
 };
 
+enum struct LatencyPolicy
+{
+    DEFAULT,     // Mailbox if available, frame count follows swapchain image count.
+    LOW_LATENCY, // Immediate or mailbox, 2 frames in flight and minimum swapchain image count.
+    THROUGHPUT,  // FIFO relaxed if available, 3 frames in flight and an extra swapchain image.
+};
+
+struct HeadlessInfo
+{
+    VkExtent2D extent;
+    VkFormat   format;
+    uint32     image_count;
+};
+
 struct ContextInfo
 {
     InstanceInfo   instance_info;
     uint32         render_thread_count;
     DeviceFeatures enabled_features;
+    bool           headless;
+    HeadlessInfo   headless_info;
+    const char*    pipeline_cache_path; // Pipeline cache is loaded from and saved to this path if not NULL.
+    const char*    physical_device;     // Overrides scored device selection by index or name substring if not NULL.
+    LatencyPolicy  latency_policy;
+    uint32         frame_count;         // Frames in flight; overrides latency policy's default if not 0.
+};
+
+struct PipelineCacheFileHeader
+{
+    uint32 driver_version;
+    uint32 data_size;
 };
 
 struct QueueFamilies
 {
     uint32 graphics;
     uint32 present;
+    uint32 transfer;
 };
 
 struct ResourceSharing
 {
     VkSharingMode mode;
     uint32        queue_family_index_count;
-    const uint32* queue_family_indexes;
+    uint32        queue_family_indexes[3];
 };
 
 struct PhysicalDevice
@@ -52,6 +80,7 @@ struct PhysicalDevice
     VkPhysicalDeviceProperties       properties;
     VkPhysicalDeviceMemoryProperties mem_properties;
     DeviceFeatures                   features;
+    float64                          score;
 };
 
 struct Swapchain
@@ -70,15 +99,39 @@ struct Swapchain
 
     // State
     VkSwapchainKHR     hnd;
+    VkImageUsageFlags  image_usage;
+    Array<VkImage>     images;
     Array<VkImageView> image_views;
+    Array<VkSemaphore> render_finished; // Per image; an image's semaphore is only reused after its present completes.
+
+    // Headless State (images and views are owned by an offscreen resource group created in InitResourceModule())
+    uint32        next_image_index;
+    Array<uint64> image_frame_values; // Frame timeline value of each image's last submission; waited on before reuse.
+};
+
+enum struct RetiredType
+{
+    SWAPCHAIN,
+    FRAMEBUFFER,
+    IMAGE_VIEW,
+    IMAGE,
+    BUFFER,
+    MEMORY,
+    SEMAPHORE,
+};
+
+struct Retired
+{
+    RetiredType type;
+    uint64      hnd;         // Non-dispatchable handle cast to uint64; cast back based on type when destroyed.
+    uint64      frame_value; // Handle is destroyed once frame timeline reaches this value.
 };
 
 struct Frame
 {
     // Sync State
     VkSemaphore image_acquired;
-    VkSemaphore render_finished;
-    VkFence     command_buffers_complete;
+    uint64      timeline_value; // Frame timeline value signaled when frame's last submitted commands complete.
 
     // Render State
     VkCommandBuffer        primary_render_command_buffer;
@@ -88,11 +141,14 @@ struct Frame
 
 struct Context
 {
-    uint32 render_thread_count;
+    uint32        render_thread_count;
+    bool          headless;
+    LatencyPolicy latency_policy;
 
     // Instance State
     VkInstance               instance;
     VkDebugUtilsMessengerEXT debug_messenger;
+    uint32                   api_version;
 
     // Device State
     VkSurfaceKHR          surface;
@@ -101,13 +157,24 @@ struct Context
     VkDevice              device;
     VkQueue               graphics_queue;
     VkQueue               present_queue;
+    VkQueue               transfer_queue;
     VkCommandPool         main_command_pool;
     VkCommandBuffer       temp_command_buffer;
 
+    // Pipeline State
+    VkPipelineCache pipeline_cache;
+    const char*     pipeline_cache_path;
+    bool            pipeline_cache_warm;
+
     // Render State
     Swapchain            swapchain;
     Array<VkCommandPool> render_command_pools;
     RingBuffer<Frame>    frames;
+    VkSemaphore          frame_timeline;       // Timeline semaphore signaled with each submitted frame's value.
+    uint64               frame_timeline_value; // Value of last submitted frame.
+
+    // Handles waiting for in-flight frames to complete before being destroyed.
+    Array<Retired> retired;
 };
 
 /// Instance
@@ -117,6 +184,8 @@ static Context g_context;
 /// Forward Declarations
 ////////////////////////////////////////////////////////////
 static void GetSurfaceCapabilities(VkSurfaceCapabilitiesKHR* capabilities);
+static VkSemaphore CreateSemaphore(VkDevice device, VkSemaphoreType type);
+static void FlushHostWrites();
 
 /// Debugging
 ////////////////////////////////////////////////////////////
@@ -203,16 +272,23 @@ static void LogDeviceFeatures(DeviceFeatures* device_features)
     PrintLine();
 }
 
+static const char* GetPhysicalDeviceTypeName(VkPhysicalDeviceType type)
+{
+    return type == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU   ? "VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU"   :
+           type == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU ? "VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU" :
+           type == VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU    ? "VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU"    :
+           type == VK_PHYSICAL_DEVICE_TYPE_CPU            ? "VK_PHYSICAL_DEVICE_TYPE_CPU"            :
+           type == VK_PHYSICAL_DEVICE_TYPE_OTHER          ? "VK_PHYSICAL_DEVICE_TYPE_OTHER"          :
+           "invalid";
+}
+
 static void LogPhysicalDevice(PhysicalDevice* physical_device)
 {
-    VkPhysicalDeviceType type = physical_device->properties.deviceType;
     VkFormat depth_image_format = physical_device->depth_image_format;
 
     PrintLine("%s:", physical_device->properties.deviceName);
-    PrintLine("    type: %s",
-        type == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU   ? "VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU" :
-        type == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU ? "VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU" :
-        "invalid");
+    PrintLine("    type: %s", GetPhysicalDeviceTypeName(physical_device->properties.deviceType));
+    PrintLine("    score: %.2f", physical_device->score);
     PrintLine("    depth_image_format: %s",
         depth_image_format == VK_FORMAT_D32_SFLOAT_S8_UINT ? "VK_FORMAT_D32_SFLOAT_S8_UINT" :
         depth_image_format == VK_FORMAT_D32_SFLOAT         ? "VK_FORMAT_D32_SFLOAT"         :
@@ -224,11 +300,30 @@ static void LogPhysicalDevice(PhysicalDevice* physical_device)
     PrintLine("    queue_families:");
     PrintLine("        graphics: %u", physical_device->queue_families.graphics);
     PrintLine("        present:  %u", physical_device->queue_families.present);
+    PrintLine("        transfer: %u", physical_device->queue_families.transfer);
     PrintLine();
     LogMemoryTypes(&physical_device->mem_properties, 2);
     LogDeviceFeatures(&physical_device->features);
 }
 
+// Logs capable physical devices in rank order and the one in use.
+static void LogPhysicalDevices()
+{
+    PrintLine("physical device ranking:");
+    for (uint32 i = 0; i < g_context.physical_devices.count; ++i)
+    {
+        PhysicalDevice* physical_device = GetPtr(&g_context.physical_devices, i);
+        PrintLine("    %u: %8.2f %s (%s)", i, physical_device->score, physical_device->properties.deviceName,
+                  GetPhysicalDeviceTypeName(physical_device->properties.deviceType));
+    }
+    PrintLine("using physical device: %s", g_context.physical_device->properties.deviceName);
+}
+
+static void LogFrames()
+{
+    PrintLine("frames in flight: %u, swapchain images: %u", g_context.frames.size, g_context.swapchain.images.count);
+}
+
 /// Internal
 ////////////////////////////////////////////////////////////
 static QueueFamilies FindQueueFamilies(VkPhysicalDevice physical_device, VkSurfaceKHR surface)
@@ -239,6 +334,7 @@ static QueueFamilies FindQueueFamilies(VkPhysicalDevice physical_device, VkSurfa
     {
         .graphics = UNSET_INDEX,
         .present  = UNSET_INDEX,
+        .transfer = UNSET_INDEX,
     };
     Array<VkQueueFamilyProperties> queue_family_properties = {};
     LoadVkQueueFamilyProperties(&queue_family_properties, &frame, physical_device);
@@ -254,6 +350,46 @@ static QueueFamilies FindQueueFamilies(VkPhysicalDevice physical_device, VkSurfa
         }
     }
 
+    // Find transfer queue family, preferring dedicated transfer-only families (usually backed by DMA engines) over
+    // async compute families. Families whose transfers aren't texel-granular can't copy arbitrary image extents, so
+    // they're skipped. Graphics queue family is used if neither exist.
+    static constexpr VkQueueFlags TRANSFER_EXCLUDED_QUEUE_FLAGS[] =
+    {
+        VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT,
+        VK_QUEUE_GRAPHICS_BIT,
+    };
+    CTK_ITER_ARRAY(excluded_queue_flags, TRANSFER_EXCLUDED_QUEUE_FLAGS)
+    {
+        for (uint32 queue_family_index = 0; queue_family_index < queue_family_properties.count; ++queue_family_index)
+        {
+            VkQueueFamilyProperties* properties = GetPtr(&queue_family_properties, queue_family_index);
+            VkExtent3D granularity = properties->minImageTransferGranularity;
+            if ((properties->queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+                !(properties->queueFlags & *excluded_queue_flags) &&
+                granularity.width == 1 && granularity.height == 1 && granularity.depth == 1)
+            {
+                queue_families.transfer = queue_family_index;
+                break;
+            }
+        }
+
+        if (queue_families.transfer != UNSET_INDEX)
+        {
+            break;
+        }
+    }
+    if (queue_families.transfer == UNSET_INDEX)
+    {
+        queue_families.transfer = queue_families.graphics;
+    }
+
+    // Headless contexts have no surface to present to, so the graphics queue family stands in for present.
+    if (surface == VK_NULL_HANDLE)
+    {
+        queue_families.present = queue_families.graphics;
+        return queue_families;
+    }
+
     // Find first present queue family.
     for (uint32 queue_family_index = 0; queue_family_index < queue_family_properties.count; ++queue_family_index)
     {
@@ -314,6 +450,7 @@ static void InitInstance(InstanceInfo* info)
 {
     CTK::Frame frame = CreateFrame();
     VkResult res = VK_SUCCESS;
+    g_context.api_version = info->api_version;
 
 #ifdef RTK_ENABLE_VALIDATION
     VkDebugUtilsMessengerCreateInfoEXT debug_msgr_info =
@@ -339,17 +476,24 @@ static void InitInstance(InstanceInfo* info)
         .apiVersion         = info->api_version,
     };
 
-    static constexpr const char* REQUIRED_EXTENSIONS[] =
+    static constexpr const char* SURFACE_EXTENSIONS[] =
     {
+#ifdef VK_USE_PLATFORM_WIN32_KHR
         VK_KHR_WIN32_SURFACE_EXTENSION_NAME,
+#endif
         VK_KHR_SURFACE_EXTENSION_NAME,
+    };
+    uint32 max_extension_count = CTK_ARRAY_SIZE(SURFACE_EXTENSIONS) + 1 + info->extensions.count; // +1: debug utils
+    auto extensions = CreateArray<const char*>(&frame, max_extension_count);
+
+    // Headless contexts never create a surface, so surface extensions aren't required.
+    if (!g_context.headless)
+    {
+        PushRange(&extensions, SURFACE_EXTENSIONS, CTK_ARRAY_SIZE(SURFACE_EXTENSIONS));
+    }
 #ifdef RTK_ENABLE_VALIDATION
-        VK_EXT_DEBUG_UTILS_EXTENSION_NAME,
+    Push(&extensions, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 #endif
-    };
-    auto extensions =
-        CreateArray<const char*>(&frame, CTK_ARRAY_SIZE(REQUIRED_EXTENSIONS) + info->extensions.count);
-    PushRange(&extensions, REQUIRED_EXTENSIONS, CTK_ARRAY_SIZE(REQUIRED_EXTENSIONS));
     PushRange(&extensions, &info->extensions);
 
 #ifdef RTK_ENABLE_VALIDATION
@@ -386,6 +530,7 @@ static void InitInstance(InstanceInfo* info)
 
 static void InitSurface()
 {
+#ifdef VK_USE_PLATFORM_WIN32_KHR
     Window* window = GetWindow();
     VkWin32SurfaceCreateInfoKHR info =
     {
@@ -395,6 +540,9 @@ static void InitSurface()
     };
     VkResult res = vkCreateWin32SurfaceKHR(g_context.instance, &info, NULL, &g_context.surface);
     Validate(res, "vkCreateWin32SurfaceKHR() failed");
+#else
+    CTK_FATAL("can't create surface: no surface platform is supported for this build; use a headless context");
+#endif
 }
 
 static void LogUnsupportedDeviceFeature(PhysicalDevice* physical_device, const char* feature_name)
@@ -430,6 +578,9 @@ LoadCapablePhysicalDevices(Stack* perm_stack, DeviceFeatures* enabled_features)
         physical_device.depth_image_format = FindDepthImageFormat(vk_physical_device);
         physical_device.queue_families     = FindQueueFamilies(vk_physical_device, g_context.surface);
 
+        vkGetPhysicalDeviceProperties(vk_physical_device, &physical_device.properties);
+        vkGetPhysicalDeviceMemoryProperties(vk_physical_device, &physical_device.mem_properties);
+
         DeviceFeatures* device_features = &physical_device.features;
         InitDeviceFeatures(device_features);
         GetDeviceFeatures(physical_device.hnd, device_features);
@@ -505,28 +656,30 @@ LoadCapablePhysicalDevices(Stack* perm_stack, DeviceFeatures* enabled_features)
 
         // Physical device is capable.
 
-        // Store properties about physical device.
-        vkGetPhysicalDeviceProperties(vk_physical_device, &physical_device.properties);
-        vkGetPhysicalDeviceMemoryProperties(vk_physical_device, &physical_device.mem_properties);
-
-        // Store resource sharing settings based on queue family indexes.
-        if (physical_device.queue_families.graphics != physical_device.queue_families.present)
+        // Store resource sharing settings based on queue family indexes. Queue family indexes are copied into the
+        // sharing settings so they remain valid after physical device is copied into the capable device list.
+        // Exclusive resources are handed between the transfer and graphics queue families by the upload module via
+        // queue family ownership transfers.
+        QueueFamilies* queue_families = &physical_device.queue_families;
+        ResourceSharing* resource_sharing = &physical_device.resource_sharing;
+        if (queue_families->graphics != queue_families->present)
         {
-            physical_device.resource_sharing =
+            resource_sharing->mode = VK_SHARING_MODE_CONCURRENT;
+            resource_sharing->queue_family_indexes[resource_sharing->queue_family_index_count++] =
+                queue_families->graphics;
+            resource_sharing->queue_family_indexes[resource_sharing->queue_family_index_count++] =
+                queue_families->present;
+            if (queue_families->transfer != queue_families->graphics &&
+                queue_families->transfer != queue_families->present)
             {
-                .mode                     = VK_SHARING_MODE_CONCURRENT,
-                .queue_family_index_count = sizeof(QueueFamilies) / sizeof(uint32),
-                .queue_family_indexes     = (const uint32*)&physical_device.queue_families,
-            };
+                resource_sharing->queue_family_indexes[resource_sharing->queue_family_index_count++] =
+                    queue_families->transfer;
+            }
         }
         else
         {
-            physical_device.resource_sharing =
-            {
-                .mode                     = VK_SHARING_MODE_EXCLUSIVE,
-                .queue_family_index_count = 0,
-                .queue_family_indexes     = NULL,
-            };
+            resource_sharing->mode                     = VK_SHARING_MODE_EXCLUSIVE;
+            resource_sharing->queue_family_index_count = 0;
         }
 
         // Add physical device to list of capable physical devices for rendering.
@@ -540,6 +693,129 @@ LoadCapablePhysicalDevices(Stack* perm_stack, DeviceFeatures* enabled_features)
     }
 }
 
+static float64 ScorePhysicalDevice(PhysicalDevice* physical_device)
+{
+    VkPhysicalDeviceProperties* properties = &physical_device->properties;
+    DeviceFeatures* features = &physical_device->features;
+    float64 score = 0.0;
+
+    // Device type dominates score so software rasterizers and virtual devices are only chosen as a last resort.
+    switch (properties->deviceType)
+    {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   score += 1000.0; break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score += 500.0;  break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    score += 250.0;  break;
+        case VK_PHYSICAL_DEVICE_TYPE_OTHER:          score += 100.0;  break;
+        default:                                     break;
+    }
+
+    // Largest device-local heap: 10 points per GiB, capped at 64 GiB.
+    VkPhysicalDeviceMemoryProperties* mem_properties = &physical_device->mem_properties;
+    VkDeviceSize max_device_local_heap_size = 0;
+    for (uint32 i = 0; i < mem_properties->memoryHeapCount; ++i)
+    {
+        VkMemoryHeap* heap = &mem_properties->memoryHeaps[i];
+        if ((heap->flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && heap->size > max_device_local_heap_size)
+        {
+            max_device_local_heap_size = heap->size;
+        }
+    }
+    float64 device_local_heap_gib = (float64)max_device_local_heap_size / (1024.0 * 1024.0 * 1024.0);
+    score += 10.0 * (device_local_heap_gib < 64.0 ? device_local_heap_gib : 64.0);
+
+    // Limits.
+    score += properties->limits.maxSamplerAnisotropy;
+    score += Log2((float32)properties->limits.maxImageDimension2D);
+    score += properties->limits.timestampComputeAndGraphics ? 5.0 : 0.0;
+
+    // Optional fast-path features.
+    VkBool32 fast_path_features[] =
+    {
+        features->vulkan_1_0.samplerAnisotropy,
+        features->vulkan_1_2.bufferDeviceAddress,
+        features->vulkan_1_2.descriptorIndexing,
+        features->vulkan_1_3.synchronization2,
+        features->vulkan_1_3.dynamicRendering,
+        features->vulkan_1_3.maintenance4,
+    };
+    CTK_ITER_ARRAY(supported, fast_path_features)
+    {
+        score += *supported == VK_TRUE ? 10.0 : 0.0;
+    }
+
+    // Dedicated transfer queue family enables async uploads.
+    if (physical_device->queue_families.transfer != physical_device->queue_families.graphics)
+    {
+        score += 10.0;
+    }
+
+    return score;
+}
+
+static void RankPhysicalDevices()
+{
+    CTK_ITER(physical_device, &g_context.physical_devices)
+    {
+        physical_device->score = ScorePhysicalDevice(physical_device);
+    }
+
+    // Sort physical devices by descending score; list is small enough that insertion sort is fine.
+    for (uint32 i = 1; i < g_context.physical_devices.count; ++i)
+    {
+        PhysicalDevice physical_device = Get(&g_context.physical_devices, i);
+        uint32 j = i;
+        for (; j > 0 && GetPtr(&g_context.physical_devices, j - 1)->score < physical_device.score; --j)
+        {
+            Set(&g_context.physical_devices, j, Get(&g_context.physical_devices, j - 1));
+        }
+        Set(&g_context.physical_devices, j, physical_device);
+    }
+}
+
+static uint32 SelectPhysicalDevice(const char* override)
+{
+    // RTK_PHYSICAL_DEVICE environment variable takes precedence over ContextInfo::physical_device.
+    const char* env_override = getenv("RTK_PHYSICAL_DEVICE");
+    if (env_override != NULL && env_override[0] != '\0')
+    {
+        override = env_override;
+    }
+
+    if (override == NULL)
+    {
+        return 0;
+    }
+
+    // Override is an index into the ranked list if it's numeric, otherwise a substring of the device's name.
+    bool numeric = true;
+    for (const char* c = override; *c != '\0'; ++c)
+    {
+        numeric &= *c >= '0' && *c <= '9';
+    }
+    if (numeric)
+    {
+        uint32 index = (uint32)atoi(override);
+        if (index < g_context.physical_devices.count)
+        {
+            return index;
+        }
+    }
+    else
+    {
+        for (uint32 i = 0; i < g_context.physical_devices.count; ++i)
+        {
+            if (strstr(GetPtr(&g_context.physical_devices, i)->properties.deviceName, override) != NULL)
+            {
+                return i;
+            }
+        }
+    }
+
+    PrintWarning("physical device override \"%s\" doesn't match any capable physical device; using highest ranked",
+                 override);
+    return 0;
+}
+
 static void UsePhysicalDevice(uint32 index)
 {
     if (index >= g_context.physical_devices.count)
@@ -555,7 +831,7 @@ static void InitDevice(DeviceFeatures* enabled_features)
     QueueFamilies* queue_families = &g_context.physical_device->queue_families;
 
     // Add queue creation info for 1 queue in each queue family.
-    FArray<VkDeviceQueueCreateInfo, 2> queue_infos = {};
+    FArray<VkDeviceQueueCreateInfo, 3> queue_infos = {};
     Push(&queue_infos, GetSingleQueueInfo(queue_families->graphics));
 
     // Don't create separate queues if present and graphics queue families are the same.
@@ -563,8 +839,13 @@ static void InitDevice(DeviceFeatures* enabled_features)
     {
         Push(&queue_infos, GetSingleQueueInfo(queue_families->present));
     }
+    if (queue_families->transfer != queue_families->graphics && queue_families->transfer != queue_families->present)
+    {
+        Push(&queue_infos, GetSingleQueueInfo(queue_families->transfer));
+    }
 
-    // Create device, specifying enabled extensions and features.
+    // Create device, specifying enabled extensions and features. Headless contexts don't present, so they don't need
+    // the swapchain extension.
     const char* enabled_extensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
     VkDeviceCreateInfo create_info =
     {
@@ -575,8 +856,8 @@ static void InitDevice(DeviceFeatures* enabled_features)
         .pQueueCreateInfos       = queue_infos.data,
         .enabledLayerCount       = 0,
         .ppEnabledLayerNames     = NULL,
-        .enabledExtensionCount   = CTK_ARRAY_SIZE(enabled_extensions),
-        .ppEnabledExtensionNames = enabled_extensions,
+        .enabledExtensionCount   = g_context.headless ? 0u : CTK_ARRAY_SIZE(enabled_extensions),
+        .ppEnabledExtensionNames = g_context.headless ? NULL : enabled_extensions,
         .pEnabledFeatures        = NULL,
     };
     VkResult res = vkCreateDevice(g_context.physical_device->hnd, &create_info, NULL, &g_context.device);
@@ -588,6 +869,7 @@ static void InitQueues()
     QueueFamilies* queue_families = &g_context.physical_device->queue_families;
     vkGetDeviceQueue(g_context.device, queue_families->graphics, 0, &g_context.graphics_queue);
     vkGetDeviceQueue(g_context.device, queue_families->present, 0, &g_context.present_queue);
+    vkGetDeviceQueue(g_context.device, queue_families->transfer, 0, &g_context.transfer_queue);
 }
 
 static void InitMainCommandState()
@@ -617,16 +899,49 @@ static void InitMainCommandState()
     Validate(res, "vkAllocateCommandBuffers() failed");
 }
 
+static Array<VkPresentModeKHR> GetPreferredPresentModes(LatencyPolicy latency_policy)
+{
+    // Ordered by preference; FIFO is the fallback for all policies as it's always available.
+    static VkPresentModeKHR DEFAULT_PRESENT_MODES[]     = { VK_PRESENT_MODE_MAILBOX_KHR };
+    static VkPresentModeKHR LOW_LATENCY_PRESENT_MODES[] =
+    {
+        VK_PRESENT_MODE_IMMEDIATE_KHR,
+        VK_PRESENT_MODE_MAILBOX_KHR,
+    };
+    static VkPresentModeKHR THROUGHPUT_PRESENT_MODES[]  = { VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+    switch (latency_policy)
+    {
+        case LatencyPolicy::DEFAULT:     return CTK_WRAP_ARRAY(DEFAULT_PRESENT_MODES);
+        case LatencyPolicy::LOW_LATENCY: return CTK_WRAP_ARRAY(LOW_LATENCY_PRESENT_MODES);
+        case LatencyPolicy::THROUGHPUT:  return CTK_WRAP_ARRAY(THROUGHPUT_PRESENT_MODES);
+        default: CTK_FATAL("unhandled latency policy: %u", (uint32)latency_policy);
+    }
+}
 
-static void CreateSwapchain(FreeList* free_list)
+static uint32 GetDefaultFrameCount(LatencyPolicy latency_policy)
 {
-    CTK::Frame frame = CreateFrame();
+    switch (latency_policy)
+    {
+        case LatencyPolicy::DEFAULT:     return Min(g_context.swapchain.image_views.count + 1, MAX_FRAME_COUNT);
+        case LatencyPolicy::LOW_LATENCY: return 2;
+        case LatencyPolicy::THROUGHPUT:  return 3;
+        default: CTK_FATAL("unhandled latency policy: %u", (uint32)latency_policy);
+    }
+}
 
+static void CreateSwapchain(FreeList* free_list, VkSwapchainKHR old_swapchain)
+{
     Swapchain* swapchain = &g_context.swapchain;
     VkDevice device = g_context.device;
     VkResult res = VK_SUCCESS;
 
-    // Create swapchain.
+    // Create swapchain. Passing the old swapchain lets the presentation engine reuse its resources and keep presenting
+    // already queued images while the new swapchain is created.
+    // Images are also used as copy sources for readback where the surface supports it.
+    VkSurfaceCapabilitiesKHR surface_capabilities = {};
+    GetSurfaceCapabilities(&surface_capabilities);
+    swapchain->image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    swapchain->image_usage |= surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
     VkSwapchainCreateInfoKHR info =
     {
         .sType                 = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
@@ -637,8 +952,7 @@ static void CreateSwapchain(FreeList* free_list)
         .imageColorSpace       = swapchain->surface_format.colorSpace,
         .imageExtent           = swapchain->surface_extent,
         .imageArrayLayers      = 1, // Always 1 for standard image
-        .imageUsage            = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
-                                 VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .imageUsage            = swapchain->image_usage,
         .imageSharingMode      = swapchain->image_sharing_mode,
         .queueFamilyIndexCount = swapchain->queue_family_index_count,
         .pQueueFamilyIndices   = swapchain->queue_family_indexes,
@@ -646,22 +960,21 @@ static void CreateSwapchain(FreeList* free_list)
         .compositeAlpha        = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .presentMode           = swapchain->surface_present_mode,
         .clipped               = VK_TRUE,
-        .oldSwapchain          = VK_NULL_HANDLE,
+        .oldSwapchain          = old_swapchain,
     };
     res = vkCreateSwapchainKHR(device, &info, NULL, &swapchain->hnd);
     Validate(res, "vkCreateSwapchainKHR() failed");
 
     // Create swapchain image views.
-    Array<VkImage> swapchain_images = {};
-    LoadVkSwapchainImages(&swapchain_images, &frame, device, swapchain->hnd);
-    swapchain->image_views = CreateArrayFull<VkImageView>(free_list, swapchain_images.count);
-    for (uint32 i = 0; i < swapchain_images.count; ++i)
+    LoadVkSwapchainImages(&swapchain->images, free_list, device, swapchain->hnd);
+    swapchain->image_views = CreateArrayFull<VkImageView>(free_list, swapchain->images.count);
+    for (uint32 i = 0; i < swapchain->images.count; ++i)
     {
         VkImageViewCreateInfo view_info =
         {
             .sType    = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
             .flags    = 0,
-            .image    = Get(&swapchain_images, i),
+            .image    = Get(&swapchain->images, i),
             .viewType = VK_IMAGE_VIEW_TYPE_2D,
             .format   = swapchain->surface_format.format,
             .components =
@@ -683,6 +996,14 @@ static void CreateSwapchain(FreeList* free_list)
         res = vkCreateImageView(device, &view_info, NULL, GetPtr(&swapchain->image_views, i));
         Validate(res, "vkCreateImageView() failed");
     }
+
+    // Create render finished semaphores for each image. Presenting an image waits on its semaphore, and the image
+    // can't be re-acquired until that present is done, so a semaphore is never signaled while a present waits on it.
+    swapchain->render_finished = CreateArrayFull<VkSemaphore>(free_list, swapchain->images.count);
+    CTK_ITER(render_finished, &swapchain->render_finished)
+    {
+        *render_finished = CreateSemaphore(device, VK_SEMAPHORE_TYPE_BINARY);
+    }
 }
 
 static void InitSwapchain(FreeList* free_list)
@@ -718,15 +1039,25 @@ static void InitSwapchain(FreeList* free_list)
         }
     }
 
-    // Default to FIFO (only present mode with guarenteed availability), check for preferred mailbox present mode.
-    static constexpr VkPresentModeKHR PREFERRED_PRESENT_MODE = VK_PRESENT_MODE_MAILBOX_KHR;
+    // Default to FIFO (only present mode with guarenteed availability), then use first available present mode
+    // preferred by latency policy.
     swapchain->surface_present_mode = VK_PRESENT_MODE_FIFO_KHR;
-    for (uint32 i = 0; i < present_modes.count; ++i)
+    Array<VkPresentModeKHR> preferred_present_modes = GetPreferredPresentModes(g_context.latency_policy);
+    for (uint32 i = 0; i < preferred_present_modes.count; ++i)
     {
-        VkPresentModeKHR surface_present_mode = Get(&present_modes, i);
-        if (surface_present_mode == PREFERRED_PRESENT_MODE)
+        VkPresentModeKHR preferred_present_mode = Get(&preferred_present_modes, i);
+        bool available = false;
+        for (uint32 j = 0; j < present_modes.count; ++j)
         {
-            swapchain->surface_present_mode = surface_present_mode;
+            if (Get(&present_modes, j) == preferred_present_mode)
+            {
+                available = true;
+                break;
+            }
+        }
+        if (available)
+        {
+            swapchain->surface_present_mode = preferred_present_mode;
             break;
         }
     }
@@ -735,8 +1066,13 @@ static void InitSwapchain(FreeList* free_list)
     swapchain->surface_extent    = surface_capabilities.currentExtent;
     swapchain->surface_transform = surface_capabilities.currentTransform;
 
-    // Set image count to min image count + 1 or max image count (whichever is smaller).
-    swapchain->surface_min_image_count = surface_capabilities.minImageCount + 1;
+    // Set image count to min image count (+ 1 unless latency policy is low latency) or max image count (whichever is
+    // smaller).
+    swapchain->surface_min_image_count = surface_capabilities.minImageCount;
+    if (g_context.latency_policy != LatencyPolicy::LOW_LATENCY)
+    {
+        swapchain->surface_min_image_count += 1;
+    }
     if (surface_capabilities.maxImageCount > 0 && swapchain->surface_min_image_count > surface_capabilities.maxImageCount)
     {
         swapchain->surface_min_image_count = surface_capabilities.maxImageCount;
@@ -747,7 +1083,7 @@ static void InitSwapchain(FreeList* free_list)
     if (queue_families->graphics != queue_families->present)
     {
         swapchain->image_sharing_mode       = VK_SHARING_MODE_CONCURRENT;
-        swapchain->queue_family_index_count = sizeof(QueueFamilies) / sizeof(uint32);
+        swapchain->queue_family_index_count = 2; // Graphics & present queue families are the first 2 members.
         swapchain->queue_family_indexes     = (uint32*)queue_families;
     }
     else
@@ -759,7 +1095,47 @@ static void InitSwapchain(FreeList* free_list)
 
     /// Create Swapchain
     ////////////////////////////////////////////////////////////
-    CreateSwapchain(free_list);
+    CreateSwapchain(free_list, VK_NULL_HANDLE);
+}
+
+static void InitHeadlessSwapchain(FreeList* free_list, HeadlessInfo* info)
+{
+    Swapchain* swapchain = &g_context.swapchain;
+    if (info->image_count == 0)
+    {
+        CTK_FATAL("can't init headless swapchain: image count must be at least 1");
+    }
+    if (info->extent.width == 0 || info->extent.height == 0)
+    {
+        CTK_FATAL("can't init headless swapchain: extent of %ux%u is invalid", info->extent.width, info->extent.height);
+    }
+
+    // Mirror the surface config a real swapchain would have so render targets, pipelines etc. can be created the
+    // same way as with a surface.
+    swapchain->surface_format =
+    {
+        .format     = info->format,
+        .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR,
+    };
+    swapchain->surface_present_mode     = VK_PRESENT_MODE_FIFO_KHR;
+    swapchain->surface_min_image_count  = info->image_count;
+    swapchain->surface_extent           = info->extent;
+    swapchain->surface_transform        = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    swapchain->image_sharing_mode       = VK_SHARING_MODE_EXCLUSIVE;
+    swapchain->queue_family_index_count = 0;
+    swapchain->queue_family_indexes     = NULL;
+
+    // Offscreen images and views are created once the resource module is initialized.
+    swapchain->hnd              = VK_NULL_HANDLE;
+    swapchain->image_usage      = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    swapchain->images             = CreateArrayFull<VkImage>    (free_list, info->image_count);
+    swapchain->image_views        = CreateArrayFull<VkImageView>(free_list, info->image_count);
+    swapchain->next_image_index   = 0;
+    swapchain->image_frame_values = CreateArrayFull<uint64>     (free_list, info->image_count);
+    CTK_ITER(image_frame_value, &swapchain->image_frame_values)
+    {
+        *image_frame_value = 0;
+    }
 }
 
 static void InitRenderCommandPools(Stack* perm_stack)
@@ -778,21 +1154,6 @@ static void InitRenderCommandPools(Stack* perm_stack)
     }
 }
 
-static VkFence CreateFence(VkDevice device)
-{
-    VkFenceCreateInfo info =
-    {
-        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-        .pNext = NULL,
-        .flags = VK_FENCE_CREATE_SIGNALED_BIT,
-    };
-    VkFence fence = VK_NULL_HANDLE;
-    VkResult res = vkCreateFence(device, &info, NULL, &fence);
-    Validate(res, "vkCreateFence() failed");
-
-    return fence;
-}
-
 static VkSemaphore CreateSemaphore(VkDevice device, VkSemaphoreType type)
 {
     VkSemaphoreTypeCreateInfo type_info =
@@ -815,21 +1176,33 @@ static VkSemaphore CreateSemaphore(VkDevice device, VkSemaphoreType type)
     return semaphore;
 }
 
-static void InitFrames(Stack* perm_stack)
+static void InitFrames(Stack* perm_stack, uint32 frame_count)
 {
     VkResult res = VK_SUCCESS;
     VkDevice device = g_context.device;
 
-    uint32 frame_count = g_context.swapchain.image_views.count + 1;
-    CTK_ASSERT(frame_count <= MAX_FRAME_COUNT);
+    // Frame count determines how many copies of per-frame buffers, images and descriptor sets are allocated, so it's
+    // kept independent of swapchain image count (frames only reference the swapchain image they acquired).
+    if (frame_count == 0)
+    {
+        frame_count = GetDefaultFrameCount(g_context.latency_policy);
+    }
+    if (frame_count > MAX_FRAME_COUNT)
+    {
+        CTK_FATAL("can't init frames: frame count of %u exceeds max frame count of %u", frame_count, MAX_FRAME_COUNT);
+    }
+
+    // Frames track GPU progress through a single timeline semaphore; value 0 is the initial value, so frames that
+    // have never been submitted are always complete.
+    g_context.frame_timeline       = CreateSemaphore(device, VK_SEMAPHORE_TYPE_TIMELINE);
+    g_context.frame_timeline_value = 0;
 
     g_context.frames = CreateRingBuffer<Frame>(perm_stack, frame_count);
     CTK_ITER(frame, &g_context.frames)
     {
         // Sync State
-        frame->image_acquired           = CreateSemaphore(device, VK_SEMAPHORE_TYPE_BINARY);
-        frame->render_finished          = CreateSemaphore(device, VK_SEMAPHORE_TYPE_BINARY);
-        frame->command_buffers_complete = CreateFence(device);
+        frame->image_acquired = CreateSemaphore(device, VK_SEMAPHORE_TYPE_BINARY);
+        frame->timeline_value = 0;
 
         // primary_render_command_buffer
         {
@@ -861,28 +1234,142 @@ static void InitFrames(Stack* perm_stack)
     }
 }
 
+static const char* ValidatePipelineCacheData(uint8* file_data, uint32 file_size)
+{
+    if (file_size < sizeof(PipelineCacheFileHeader) + sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        return "file is too small to contain pipeline cache headers";
+    }
+
+    // Validate file header written by SavePipelineCache().
+    auto file_header = (PipelineCacheFileHeader*)file_data;
+    VkPhysicalDeviceProperties* properties = &g_context.physical_device->properties;
+    if (file_header->data_size != file_size - sizeof(PipelineCacheFileHeader))
+    {
+        return "cache data size doesn't match file size";
+    }
+    if (file_header->driver_version != properties->driverVersion)
+    {
+        return "driver version doesn't match physical device's driver version";
+    }
+
+    // Validate Vulkan's pipeline cache header.
+    VkPipelineCacheHeaderVersionOne cache_header = {};
+    memcpy(&cache_header, file_data + sizeof(PipelineCacheFileHeader), sizeof(cache_header));
+    if (cache_header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) ||
+        cache_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        return "cache header is invalid";
+    }
+    if (cache_header.vendorID != properties->vendorID || cache_header.deviceID != properties->deviceID)
+    {
+        return "vendor/device IDs don't match physical device's vendor/device IDs";
+    }
+    if (memcmp(cache_header.pipelineCacheUUID, properties->pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        return "cache UUID doesn't match physical device's pipeline cache UUID";
+    }
+
+    return NULL;
+}
+
+static void InitPipelineCache(const char* path)
+{
+    g_context.pipeline_cache_path = path;
+    g_context.pipeline_cache_warm = false;
+
+    // Load previously saved cache data if it exists and was saved by the same device and driver; otherwise start with
+    // an empty cache.
+    uint8* file_data = NULL;
+    uint32 file_size = 0;
+    if (path != NULL)
+    {
+        FILE* file = fopen(path, "rb");
+        if (file != NULL)
+        {
+            fseek(file, 0, SEEK_END);
+            file_size = (uint32)ftell(file);
+            fseek(file, 0, SEEK_SET);
+            file_data = Allocate<uint8>(&g_std_allocator, file_size);
+            if (fread(file_data, 1, file_size, file) != file_size)
+            {
+                file_size = 0;
+            }
+            fclose(file);
+
+            const char* invalid_reason = ValidatePipelineCacheData(file_data, file_size);
+            if (invalid_reason != NULL)
+            {
+                PrintWarning("discarding pipeline cache '%s': %s", path, invalid_reason);
+                file_size = 0;
+            }
+        }
+    }
+
+    bool load_data = file_size > 0;
+    VkPipelineCacheCreateInfo info =
+    {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .pNext           = NULL,
+        .flags           = 0,
+        .initialDataSize = load_data ? file_size - sizeof(PipelineCacheFileHeader) : 0,
+        .pInitialData    = load_data ? file_data + sizeof(PipelineCacheFileHeader) : NULL,
+    };
+    VkResult res = vkCreatePipelineCache(g_context.device, &info, NULL, &g_context.pipeline_cache);
+    Validate(res, "vkCreatePipelineCache() failed");
+    g_context.pipeline_cache_warm = load_data;
+
+    if (file_data != NULL)
+    {
+        Deallocate(&g_std_allocator, file_data);
+    }
+}
+
 /// Interface
 ////////////////////////////////////////////////////////////
 static void InitContext(Stack* perm_stack, FreeList* free_list, ContextInfo* info)
 {
     g_context.render_thread_count = info->render_thread_count;
+    g_context.headless            = info->headless;
+    g_context.latency_policy      = info->latency_policy;
+
+    // Frame pacing and the upload module track GPU progress with timeline semaphores, render targets use imageless
+    // framebuffers so swapchain recreation doesn't require recreating them, the GPU profiler resets its queries from the
+    // host so render passes don't need to be split, and buffers expose device addresses for bindless data access.
+    info->enabled_features.vulkan_1_2.timelineSemaphore    = VK_TRUE;
+    info->enabled_features.vulkan_1_2.imagelessFramebuffer = VK_TRUE;
+    info->enabled_features.vulkan_1_2.hostQueryReset       = VK_TRUE;
+    info->enabled_features.vulkan_1_2.bufferDeviceAddress  = VK_TRUE;
 
     InitInstance(&info->instance_info);
-    InitSurface();
+    if (!g_context.headless)
+    {
+        InitSurface();
+    }
 
-    // Load capable physical devices and select the first one.
+    // Load capable physical devices and select the highest ranked one unless overridden.
     LoadCapablePhysicalDevices(perm_stack, &info->enabled_features);
-    UsePhysicalDevice(0);
+    RankPhysicalDevices();
+    UsePhysicalDevice(SelectPhysicalDevice(info->physical_device));
 
     // Initialize device state.
     InitDevice(&info->enabled_features);
     InitQueues();
     InitMainCommandState();
+    InitPipelineCache(info->pipeline_cache_path);
 
     // Initialize rendering state.
-    InitSwapchain(free_list);
+    if (g_context.headless)
+    {
+        InitHeadlessSwapchain(free_list, &info->headless_info);
+    }
+    else
+    {
+        InitSwapchain(free_list);
+    }
     InitRenderCommandPools(perm_stack);
-    InitFrames(perm_stack);
+    InitFrames(perm_stack, info->frame_count);
+    g_context.retired = CreateArray<Retired>(perm_stack, MAX_RETIRED);
 };
 
 static VkInstance GetInstance()
@@ -903,12 +1390,76 @@ static PhysicalDevice* GetPhysicalDevice()
     return g_context.physical_device;
 }
 
+// Device level functionality is limited to the lower of the instance's and physical device's API versions.
+static uint32 GetDeviceAPIVersion()
+{
+    return Min(g_context.api_version, GetPhysicalDevice()->properties.apiVersion);
+}
+
 static Swapchain* GetSwapchain()
 {
-    CTK_ASSERT(g_context.swapchain.hnd != VK_NULL_HANDLE);
+    CTK_ASSERT(g_context.headless || g_context.swapchain.hnd != VK_NULL_HANDLE);
     return &g_context.swapchain;
 }
 
+static bool IsHeadless()
+{
+    return g_context.headless;
+}
+
+static VkPipelineCache GetPipelineCache()
+{
+    CTK_ASSERT(g_context.pipeline_cache != VK_NULL_HANDLE);
+    return g_context.pipeline_cache;
+}
+
+static bool PipelineCacheIsWarm()
+{
+    return g_context.pipeline_cache_warm;
+}
+
+static void SavePipelineCache()
+{
+    if (g_context.pipeline_cache_path == NULL)
+    {
+        return;
+    }
+
+    VkDevice device = g_context.device;
+    VkResult res = VK_SUCCESS;
+
+    size_t data_size = 0;
+    res = vkGetPipelineCacheData(device, g_context.pipeline_cache, &data_size, NULL);
+    Validate(res, "vkGetPipelineCacheData() failed");
+
+    // Prefix cache data with header used to validate it against the device and driver when loaded.
+    uint32 file_size = sizeof(PipelineCacheFileHeader) + (uint32)data_size;
+    uint8* file_data = Allocate<uint8>(&g_std_allocator, file_size);
+    uint8* data = file_data + sizeof(PipelineCacheFileHeader);
+    res = vkGetPipelineCacheData(device, g_context.pipeline_cache, &data_size, data);
+    Validate(res, "vkGetPipelineCacheData() failed");
+
+    auto file_header = (PipelineCacheFileHeader*)file_data;
+    file_header->driver_version = g_context.physical_device->properties.driverVersion;
+    file_header->data_size      = (uint32)data_size;
+
+    FILE* file = fopen(g_context.pipeline_cache_path, "wb");
+    if (file == NULL)
+    {
+        PrintWarning("failed to open pipeline cache '%s' for writing", g_context.pipeline_cache_path);
+    }
+    else
+    {
+        if (fwrite(file_data, 1, file_size, file) != file_size)
+        {
+            PrintWarning("failed to write pipeline cache '%s'", g_context.pipeline_cache_path);
+        }
+        fclose(file);
+    }
+
+    Deallocate(&g_std_allocator, file_data);
+}
+
 static VkCommandBuffer GetTempCommandBuffer()
 {
     CTK_ASSERT(g_context.temp_command_buffer != VK_NULL_HANDLE);
@@ -927,6 +1478,12 @@ static VkQueue GetPresentQueue()
     return g_context.present_queue;
 }
 
+static VkQueue GetTransferQueue()
+{
+    CTK_ASSERT(g_context.transfer_queue != VK_NULL_HANDLE);
+    return g_context.transfer_queue;
+}
+
 static uint32 GetFrameCount()
 {
     return g_context.frames.size;
@@ -947,8 +1504,129 @@ static uint32 GetRenderThreadCount()
     return g_context.render_thread_count;
 }
 
+static VkSemaphore GetFrameTimeline()
+{
+    CTK_ASSERT(g_context.frame_timeline != VK_NULL_HANDLE);
+    return g_context.frame_timeline;
+}
+
+static uint64 GetSubmittedFrameValue()
+{
+    return g_context.frame_timeline_value;
+}
+
+static uint64 GetCompletedFrameValue()
+{
+    uint64 value = 0;
+    VkResult res = vkGetSemaphoreCounterValue(g_context.device, g_context.frame_timeline, &value);
+    Validate(res, "vkGetSemaphoreCounterValue() failed");
+
+    return value;
+}
+
+static void WaitFrameValue(uint64 value)
+{
+    VkSemaphoreWaitInfo wait_info =
+    {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext          = NULL,
+        .flags          = 0,
+        .semaphoreCount = 1,
+        .pSemaphores    = &g_context.frame_timeline,
+        .pValues        = &value,
+    };
+    VkResult res = vkWaitSemaphores(g_context.device, &wait_info, UINT64_MAX);
+    Validate(res, "vkWaitSemaphores() failed");
+}
+
+static uint64 SignalNextFrameValue()
+{
+    g_context.frame_timeline_value += 1;
+    GetCurrentPtr(&g_context.frames)->timeline_value = g_context.frame_timeline_value;
+    return g_context.frame_timeline_value;
+}
+
+static void DestroyRetired(Retired* retired)
+{
+    VkDevice device = g_context.device;
+    switch (retired->type)
+    {
+        case RetiredType::SWAPCHAIN:   vkDestroySwapchainKHR(device, (VkSwapchainKHR)retired->hnd, NULL); break;
+        case RetiredType::FRAMEBUFFER: vkDestroyFramebuffer (device, (VkFramebuffer) retired->hnd, NULL); break;
+        case RetiredType::IMAGE_VIEW:  vkDestroyImageView   (device, (VkImageView)   retired->hnd, NULL); break;
+        case RetiredType::IMAGE:       vkDestroyImage       (device, (VkImage)       retired->hnd, NULL); break;
+        case RetiredType::BUFFER:      vkDestroyBuffer      (device, (VkBuffer)      retired->hnd, NULL); break;
+        case RetiredType::MEMORY:      vkFreeMemory         (device, (VkDeviceMemory)retired->hnd, NULL); break;
+        case RetiredType::SEMAPHORE:   vkDestroySemaphore   (device, (VkSemaphore)   retired->hnd, NULL); break;
+        default: CTK_FATAL("unhandled retired type: %u", (uint32)retired->type);
+    }
+}
+
+static void Retire(RetiredType type, uint64 hnd)
+{
+    if (!CanPush(&g_context.retired, 1))
+    {
+        CTK_FATAL("can't retire handle: retired handle count has reached max of %u", g_context.retired.size);
+    }
+
+    // Handle may be referenced by any frame submitted so far, so it's destroyed once the last submitted frame
+    // completes. Swapchains (and the render finished semaphores their presents wait on) can still be presenting after
+    // their last frame's commands complete, so they wait for a full cycle of the frame ring.
+    uint64 frame_value = g_context.frame_timeline_value;
+    if (type == RetiredType::SWAPCHAIN || type == RetiredType::SEMAPHORE)
+    {
+        frame_value += g_context.frames.size;
+    }
+
+    Push(&g_context.retired,
+    {
+        .type        = type,
+        .hnd         = hnd,
+        .frame_value = frame_value,
+    });
+}
+
+static void DestroyCompletedRetired()
+{
+    // Destroy retired handles whose frames have completed, compacting the remaining handles in place.
+    uint64 completed_frame_value = GetCompletedFrameValue();
+    uint32 remaining_count = 0;
+    for (uint32 i = 0; i < g_context.retired.count; ++i)
+    {
+        Retired* retired = GetPtr(&g_context.retired, i);
+        if (retired->frame_value <= completed_frame_value)
+        {
+            DestroyRetired(retired);
+        }
+        else
+        {
+            Set(&g_context.retired, remaining_count, *retired);
+            ++remaining_count;
+        }
+    }
+    g_context.retired.count = remaining_count;
+}
+
 static void GetSurfaceCapabilities(VkSurfaceCapabilitiesKHR* capabilities)
 {
+    // Headless contexts report their fixed offscreen extent so surface-driven loops work unchanged.
+    if (g_context.headless)
+    {
+        Swapchain* swapchain = &g_context.swapchain;
+        *capabilities = {};
+        capabilities->minImageCount           = swapchain->images.count;
+        capabilities->maxImageCount           = swapchain->images.count;
+        capabilities->currentExtent           = swapchain->surface_extent;
+        capabilities->minImageExtent          = swapchain->surface_extent;
+        capabilities->maxImageExtent          = swapchain->surface_extent;
+        capabilities->maxImageArrayLayers     = 1;
+        capabilities->supportedTransforms     = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        capabilities->currentTransform        = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        capabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+        capabilities->supportedUsageFlags     = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        return;
+    }
+
     VkResult res =
         vkGetPhysicalDeviceSurfaceCapabilitiesKHR(g_context.physical_device->hnd, g_context.surface, capabilities);
     Validate(res, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR() failed");
@@ -969,6 +1647,7 @@ static void BeginTempCommandBuffer()
 static void SubmitTempCommandBuffer()
 {
     vkEndCommandBuffer(g_context.temp_command_buffer);
+    FlushHostWrites();
 
     VkSubmitInfo submit_info =
     {
@@ -990,23 +1669,37 @@ static void SubmitTempCommandBuffer()
 
 static void UpdateSwapchainSurfaceExtent(FreeList* free_list)
 {
+    if (g_context.headless)
+    {
+        CTK_FATAL("can't update swapchain surface extent: headless contexts have a fixed extent");
+    }
+
     Swapchain* swapchain = &g_context.swapchain;
 
-    // Destroy swapchain image views.
+    // Retire swapchain image views; in-flight frames may still be rendering to them.
     for (uint32 i = 0; i < swapchain->image_views.count; ++i)
     {
-        vkDestroyImageView(g_context.device, Get(&swapchain->image_views, i), NULL);
+        Retire(RetiredType::IMAGE_VIEW, (uint64)Get(&swapchain->image_views, i));
     }
     DestroyArray(&swapchain->image_views);
+    DestroyArray(&swapchain->images);
+
+    // Retire render finished semaphores; queued presents of old swapchain images may still be waiting on them.
+    CTK_ITER(render_finished, &swapchain->render_finished)
+    {
+        Retire(RetiredType::SEMAPHORE, (uint64)*render_finished);
+    }
+    DestroyArray(&swapchain->render_finished);
 
     // Update swapchain surface extent.
     VkSurfaceCapabilitiesKHR surface_capabilities = {};
     GetSurfaceCapabilities(&surface_capabilities);
     g_context.swapchain.surface_extent = surface_capabilities.currentExtent;
 
-    // Recreate swapchain.
-    vkDestroySwapchainKHR(g_context.device, swapchain->hnd, NULL);
-    CreateSwapchain(free_list);
+    // Recreate swapchain from old swapchain, then retire old swapchain rather than waiting for the device to idle.
+    VkSwapchainKHR old_swapchain = swapchain->hnd;
+    CreateSwapchain(free_list, old_swapchain);
+    Retire(RetiredType::SWAPCHAIN, (uint64)old_swapchain);
 }
 
 static void WaitIdle()
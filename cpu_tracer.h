@@ -0,0 +1,180 @@
+/// Macros
+////////////////////////////////////////////////////////////
+#define RTK_TRACE_CONCAT_IMPL(A, B) A ## B
+#define RTK_TRACE_CONCAT(A, B) RTK_TRACE_CONCAT_IMPL(A, B)
+#define RTK_TRACE_SCOPE(NAME) RTK::CPUTraceScope RTK_TRACE_CONCAT(cpu_trace_scope_, __LINE__)(NAME)
+
+/// Data
+////////////////////////////////////////////////////////////
+struct CPUTracerInfo
+{
+    uint32 max_threads;
+    uint32 max_events_per_thread; // Per-thread event buffers wrap, keeping the most recent events.
+};
+
+struct CPUTraceEvent
+{
+    const char* name;
+    uint64      start_ns;
+    uint64      end_ns;
+};
+
+// Only the owning thread writes to its buffer, so events are recorded without locks. Buffers are read when exporting,
+// which must be done while no traced scopes are running (e.g. after the main loop).
+struct CPUTraceThread
+{
+    uint32               id;
+    Array<CPUTraceEvent> events;
+    uint64               event_count; // Total events recorded; events[event_count % events.size] is next written.
+};
+
+struct CPUTracer
+{
+    bool                  enabled;
+    uint64                start_ns;
+    Array<CPUTraceThread> threads;
+    std::atomic<uint32>   thread_count; // Threads are registered on their first traced scope.
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static CPUTracer g_cpu_tracer;
+static thread_local CPUTraceThread* t_cpu_trace_thread;
+
+/// Utils
+////////////////////////////////////////////////////////////
+// Monotonic wall-clock time; unlike clock(), this isn't affected by how many threads are running.
+static uint64 GetTimeNS()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter = {};
+    QueryPerformanceCounter(&counter);
+    uint64 seconds = (uint64)counter.QuadPart / (uint64)frequency.QuadPart;
+    uint64 remainder = (uint64)counter.QuadPart % (uint64)frequency.QuadPart;
+    return (seconds * 1000000000ull) + ((remainder * 1000000000ull) / (uint64)frequency.QuadPart);
+#else
+    timespec time = {};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return ((uint64)time.tv_sec * 1000000000ull) + (uint64)time.tv_nsec;
+#endif
+}
+
+static float64 GetElapsedMS(uint64 start_ns)
+{
+    return (float64)(GetTimeNS() - start_ns) / 1000000.0;
+}
+
+static CPUTraceThread* GetCPUTraceThread()
+{
+    if (t_cpu_trace_thread == NULL)
+    {
+        uint32 thread_index = g_cpu_tracer.thread_count.fetch_add(1);
+        if (thread_index >= g_cpu_tracer.threads.count)
+        {
+            CTK_FATAL("can't register CPU trace thread: already at max thread count of %u",
+                      g_cpu_tracer.threads.count);
+        }
+        t_cpu_trace_thread = GetPtr(&g_cpu_tracer.threads, thread_index);
+    }
+    return t_cpu_trace_thread;
+}
+
+static void RecordCPUTraceEvent(const char* name, uint64 start_ns, uint64 end_ns)
+{
+    CPUTraceThread* thread = GetCPUTraceThread();
+    Set(&thread->events, (uint32)(thread->event_count % thread->events.count),
+    {
+        .name     = name,
+        .start_ns = start_ns,
+        .end_ns   = end_ns,
+    });
+    ++thread->event_count;
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitCPUTracer(Allocator* allocator, CPUTracerInfo* info)
+{
+    g_cpu_tracer.start_ns = GetTimeNS();
+    g_cpu_tracer.threads  = CreateArrayFull<CPUTraceThread>(allocator, info->max_threads);
+    for (uint32 i = 0; i < info->max_threads; ++i)
+    {
+        CPUTraceThread* thread = GetPtr(&g_cpu_tracer.threads, i);
+        thread->id          = i;
+        thread->events      = CreateArrayFull<CPUTraceEvent>(allocator, info->max_events_per_thread);
+        thread->event_count = 0;
+    }
+    g_cpu_tracer.thread_count = 0;
+    g_cpu_tracer.enabled      = true;
+
+    // Register calling thread first so it's always thread 0.
+    GetCPUTraceThread();
+}
+
+struct CPUTraceScope
+{
+    const char* name;
+    uint64      start_ns;
+
+    CPUTraceScope(const char* scope_name)
+    {
+        name     = scope_name;
+        start_ns = g_cpu_tracer.enabled ? GetTimeNS() : 0;
+    }
+
+    ~CPUTraceScope()
+    {
+        if (g_cpu_tracer.enabled)
+        {
+            RecordCPUTraceEvent(name, start_ns, GetTimeNS());
+        }
+    }
+};
+
+// Writes recorded events in Chrome trace-event format (load in chrome://tracing or ui.perfetto.dev).
+static void WriteCPUTrace(const char* path)
+{
+    if (!g_cpu_tracer.enabled)
+    {
+        return;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        PrintWarning("failed to open CPU trace file \"%s\" for writing", path);
+        return;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first_event = true;
+    uint32 thread_count = Min(g_cpu_tracer.thread_count.load(), g_cpu_tracer.threads.count);
+    for (uint32 thread_index = 0; thread_index < thread_count; ++thread_index)
+    {
+        CPUTraceThread* thread = GetPtr(&g_cpu_tracer.threads, thread_index);
+
+        // Thread name metadata.
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}",
+                first_event ? "" : ",\n", thread->id, thread_index == 0 ? "main" : "worker", thread->id);
+        first_event = false;
+
+        // Events, oldest first if buffer has wrapped.
+        uint32 capacity = thread->events.count;
+        uint64 first = thread->event_count > capacity ? thread->event_count - capacity : 0;
+        for (uint64 i = first; i < thread->event_count; ++i)
+        {
+            CPUTraceEvent* event = GetPtr(&thread->events, (uint32)(i % capacity));
+            float64 ts_us  = (float64)(event->start_ns - g_cpu_tracer.start_ns) / 1000.0;
+            float64 dur_us = (float64)(event->end_ns - event->start_ns) / 1000.0;
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    event->name, thread->id, ts_us, dur_us);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+}
@@ -0,0 +1,568 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint32 MAX_DEFRAG_MIP_LEVELS = 16;
+
+struct DefragmenterInfo
+{
+    uint32 max_moves_per_frame;
+    uint32 max_pending_moves; // Max moved frame ranges waiting for the frame copying them to complete.
+};
+
+// Frame range a resource was moved out of. The range is freed, and a moved image's old image and view destroyed, once
+// the frame that copies out of it completes.
+struct DefragMove
+{
+    uint32        group_index;
+    Suballocator* suballocator; // NULL if group was deallocated, so only the old image needs to be destroyed.
+    uint32        block_index;
+    VkImage       image;        // VK_NULL_HANDLE for buffers.
+    VkImageView   view;
+    uint64        frame_value;
+};
+
+struct DefragStats
+{
+    uint64       buffer_move_count;
+    uint64       image_move_count;
+    VkDeviceSize moved_bytes;
+    VkDeviceSize reclaimed_bytes; // Bytes suballocators' extents shrank by, freeing contiguous space at their ends.
+};
+
+struct Defragmenter
+{
+    bool                   enabled;
+    uint32                 max_moves_per_frame;
+    VkCommandPool          command_pool;
+    Array<VkCommandBuffer> command_buffers;         // One per frame; submitted before frame's render commands.
+    bool                   recording;               // Current frame's command buffer has copies recorded.
+    Array<DefragMove>      pending_moves;
+    uint32                 dirty_descriptor_frames; // Bit per frame whose descriptor sets reference moved resources.
+    uint32                 group_index;             // Group cursors below apply to.
+    uint32                 next_buffer_index;
+    uint32                 next_image_index;
+    DefragStats            stats;
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static Defragmenter g_defragmenter;
+
+/// Utils
+////////////////////////////////////////////////////////////
+static VkCommandBuffer GetDefragCommandBuffer()
+{
+    VkCommandBuffer command_buffer = Get(&g_defragmenter.command_buffers, GetFrameIndex());
+    if (g_defragmenter.recording)
+    {
+        return command_buffer;
+    }
+
+    BeginUploadCommandBuffer(command_buffer);
+    g_defragmenter.recording = true;
+
+    // Copies must wait for previously submitted frames to finish accessing the resources being moved.
+    VkMemoryBarrier barrier =
+    {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext         = NULL,
+        .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // Source Stage Mask
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,     // Destination Stage Mask
+                         0,                                  // Dependency Flags
+                         1, &barrier,                        // Memory Barriers
+                         0, NULL,                            // Buffer Memory Barriers
+                         0, NULL);                           // Image Memory Barriers
+
+    return command_buffer;
+}
+
+// Destroyed resources keep their ranges until reclaimed, so they're skipped rather than moved.
+static bool IsPendingDestroy(PendingDestroyType type, uint32 group_index, uint32 index)
+{
+    CTK_ITER(pending_destroy, &g_pending_destroys)
+    {
+        if (pending_destroy->type == type && pending_destroy->group_index == group_index &&
+            pending_destroy->index == index)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void PushDefragMove(uint32 group_index, Suballocator* suballocator, uint32 block_index, VkImage image,
+                           VkImageView view)
+{
+    // Old range may be read by the current frame's copies, which complete along with the current frame.
+    Push(&g_defragmenter.pending_moves,
+    {
+        .group_index  = group_index,
+        .suballocator = suballocator,
+        .block_index  = block_index,
+        .image        = image,
+        .view         = view,
+        .frame_value  = GetSubmittedFrameValue() + 1,
+    });
+}
+
+// Suballocates new frame ranges, keeping them only if every frame moves toward the start of memory so repeated passes
+// compact memory rather than shuffle resources around.
+static bool SuballocateLowerFrames(Suballocation* suballocations, Suballocator* suballocator, uint32 frame_count,
+                                   VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* old_offsets)
+{
+    if (!SuballocateFrames(suballocations, suballocator, frame_count, size, alignment))
+    {
+        return false;
+    }
+
+    for (uint32 frame_index = 0; frame_index < frame_count; ++frame_index)
+    {
+        if (suballocations[frame_index].offset >= old_offsets[frame_index])
+        {
+            for (uint32 i = 0; i < frame_count; ++i)
+            {
+                FreeSuballocation(suballocator, suballocations[i].block_index);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool MoveBuffer(ResourceGroup* res_group, uint32 group_index, uint32 buffer_index)
+{
+    // Only live sub-buffers are suballocated, so only they can be moved.
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    if (buffer_state->parent_index == UNSET_INDEX ||
+        GetBufferFrameState(res_group, buffer_index, 0)->suballocation == UNSET_INDEX ||
+        IsPendingDestroy(PendingDestroyType::BUFFER, group_index, buffer_index))
+    {
+        return false;
+    }
+
+    // Host visible buffers stay put since callers may hold pointers to their mapped memory, and buffers with live
+    // sub-buffers stay put since their offsets are baked into their sub-buffers' frame states.
+    ResourceMemory* res_mem = GetResourceMemory(res_group, buffer_state->res_mem_index);
+    Suballocator* own_suballocator = res_group->buffer_suballocators[buffer_index];
+    VkBufferUsageFlags copy_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if ((res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) ||
+        (res_mem->buffer_usage & copy_usage) != copy_usage ||
+        (own_suballocator != NULL && own_suballocator->allocation_count > 0))
+    {
+        return false;
+    }
+
+    VkDeviceSize size = buffer_state->size;
+    VkDeviceSize alignment = buffer_state->alignment;
+    if (buffer_state->page_index != UNSET_INDEX &&
+        buffer_state->suballocator == GetResourceMemoryPage(res_group, buffer_state->page_index)->suballocator)
+    {
+        ApplyPageGranularity(&size, &alignment);
+    }
+
+    VkDeviceSize old_offsets[MAX_FRAME_COUNT] = {};
+    for (uint32 frame_index = 0; frame_index < buffer_state->frame_count; ++frame_index)
+    {
+        old_offsets[frame_index] = GetBufferFrameState(res_group, buffer_index, frame_index)->res_mem_offset;
+    }
+    Suballocation suballocations[MAX_FRAME_COUNT] = {};
+    if (!SuballocateLowerFrames(suballocations, buffer_state->suballocator, buffer_state->frame_count, size,
+                                alignment, old_offsets))
+    {
+        return false;
+    }
+
+    // Copy each frame's range within buffer, then point frame states at new ranges.
+    FArray<VkBufferCopy, MAX_FRAME_COUNT> regions = {};
+    for (uint32 frame_index = 0; frame_index < buffer_state->frame_count; ++frame_index)
+    {
+        BufferFrameState* buffer_frame_state = GetBufferFrameState(res_group, buffer_index, frame_index);
+        Push(&regions,
+        {
+            .srcOffset = buffer_frame_state->res_mem_offset,
+            .dstOffset = suballocations[frame_index].offset,
+            .size      = buffer_state->size,
+        });
+        PushDefragMove(group_index, buffer_state->suballocator, buffer_frame_state->suballocation, VK_NULL_HANDLE,
+                       VK_NULL_HANDLE);
+        buffer_frame_state->res_mem_offset = suballocations[frame_index].offset;
+        buffer_frame_state->suballocation  = suballocations[frame_index].block_index;
+    }
+    VkBuffer buffer = GetBuffer(res_group, buffer_index);
+    vkCmdCopyBuffer(GetDefragCommandBuffer(), buffer, buffer, regions.count, regions.data);
+    ResetBufferSuballocator(res_group, buffer_index);
+
+    g_defragmenter.stats.buffer_move_count += 1;
+    g_defragmenter.stats.moved_bytes += buffer_state->size * buffer_state->frame_count;
+    return true;
+}
+
+static void TransitionDefragImage(VkCommandBuffer command_buffer, VkImage image, VkImageLayout old_layout,
+                                  VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access,
+                                  VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage)
+{
+    VkImageMemoryBarrier barrier =
+    {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext               = NULL,
+        .srcAccessMask       = src_access,
+        .dstAccessMask       = dst_access,
+        .oldLayout           = old_layout,
+        .newLayout           = new_layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = image,
+        .subresourceRange    =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount     = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+    vkCmdPipelineBarrier(command_buffer,
+                         src_stage,    // Source Stage Mask
+                         dst_stage,    // Destination Stage Mask
+                         0,            // Dependency Flags
+                         0, NULL,      // Memory Barriers
+                         0, NULL,      // Buffer Memory Barriers
+                         1, &barrier); // Image Memory Barriers
+}
+
+static bool MoveImage(ResourceGroup* res_group, uint32 group_index, uint32 image_index)
+{
+    ImageState* image_state = GetImageState(res_group, image_index);
+    if (GetImageFrameState(res_group, image_index, 0)->image == VK_NULL_HANDLE || image_state->dedicated ||
+        IsPendingDestroy(PendingDestroyType::IMAGE, group_index, image_index))
+    {
+        return false;
+    }
+
+    // Image layouts aren't tracked, so only sampled color images are moved, which are assumed to be in the
+    // SHADER_READ_ONLY_OPTIMAL layout descriptor sets bind them with. Attachments and storage images stay put.
+    ImageMemoryInfo* image_mem_info = GetImageMemoryInfo(res_group, image_state->image_mem_index);
+    ImageInfo* image_info = GetImageInfo(res_group, image_index);
+    ImageViewInfo* image_view_info = GetImageViewInfo(res_group, image_index);
+    VkImageUsageFlags required_usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                       VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                       VK_IMAGE_USAGE_SAMPLED_BIT;
+    VkImageUsageFlags excluded_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                       VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                       VK_IMAGE_USAGE_STORAGE_BIT;
+    if ((image_mem_info->usage & required_usage) != required_usage ||
+        (image_mem_info->usage & excluded_usage) != 0 ||
+        image_view_info->subresource_range.aspectMask != VK_IMAGE_ASPECT_COLOR_BIT ||
+        image_info->mip_levels > MAX_DEFRAG_MIP_LEVELS)
+    {
+        return false;
+    }
+
+    VkDeviceSize size = image_state->size;
+    VkDeviceSize alignment = image_state->alignment;
+    Suballocator* suballocator = NULL;
+    VkDeviceMemory device_mem = VK_NULL_HANDLE;
+    VkDeviceSize image_mem_offset = 0;
+    if (image_state->page_index != UNSET_INDEX)
+    {
+        ResourceMemoryPage* page = GetResourceMemoryPage(res_group, image_state->page_index);
+        suballocator = page->suballocator;
+        device_mem   = page->hnd;
+        ApplyPageGranularity(&size, &alignment);
+    }
+    else
+    {
+        ImageMemoryState* image_mem_state = GetImageMemoryState(res_group, image_state->image_mem_index);
+        suballocator     = GetImageMemorySuballocator(res_group, image_state->image_mem_index);
+        device_mem       = GetResourceMemory(res_group, image_mem_state->res_mem_index)->hnd;
+        image_mem_offset = image_mem_state->res_mem_offset;
+    }
+
+    VkDeviceSize old_offsets[MAX_FRAME_COUNT] = {};
+    for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
+    {
+        old_offsets[frame_index] = image_mem_offset +
+                                   GetImageFrameState(res_group, image_index, frame_index)->image_mem_offset;
+    }
+    Suballocation suballocations[MAX_FRAME_COUNT] = {};
+    if (!SuballocateLowerFrames(suballocations, suballocator, image_state->frame_count, size, alignment, old_offsets))
+    {
+        return false;
+    }
+
+    // Copy each frame's image to a new image bound at its new range, then recreate its view.
+    VkDevice device = GetDevice();
+    VkCommandBuffer command_buffer = GetDefragCommandBuffer();
+    FArray<VkImageCopy, MAX_DEFRAG_MIP_LEVELS> regions = {};
+    for (uint32 mip_level = 0; mip_level < image_info->mip_levels; ++mip_level)
+    {
+        VkImageSubresourceLayers subresource =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel       = mip_level,
+            .baseArrayLayer = 0,
+            .layerCount     = image_info->array_layers,
+        };
+        Push(&regions,
+        {
+            .srcSubresource = subresource,
+            .srcOffset      = { 0, 0, 0 },
+            .dstSubresource = subresource,
+            .dstOffset      = { 0, 0, 0 },
+            .extent         =
+            {
+                .width  = Max(image_info->extent.width  >> mip_level, 1u),
+                .height = Max(image_info->extent.height >> mip_level, 1u),
+                .depth  = Max(image_info->extent.depth  >> mip_level, 1u),
+            },
+        });
+    }
+    for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
+    {
+        ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_index, frame_index);
+        VkImage old_image = image_frame_state->image;
+        VkImage new_image = CreateFrameImage(image_mem_info, image_info);
+        VkResult res = vkBindImageMemory(device, new_image, device_mem, suballocations[frame_index].offset);
+        Validate(res, "vkBindImageMemory() failed");
+
+        TransitionDefragImage(command_buffer, old_image,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                              VK_ACCESS_NONE, VK_ACCESS_TRANSFER_READ_BIT,
+                              VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        TransitionDefragImage(command_buffer, new_image,
+                              VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              VK_ACCESS_NONE, VK_ACCESS_TRANSFER_WRITE_BIT,
+                              VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        vkCmdCopyImage(command_buffer,
+                       old_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       new_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       regions.count, regions.data);
+        TransitionDefragImage(command_buffer, new_image,
+                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                              VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                              VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+        PushDefragMove(group_index, suballocator, image_frame_state->suballocation, old_image,
+                       image_frame_state->view);
+        image_frame_state->image            = new_image;
+        image_frame_state->view             = CreateFrameImageView(new_image, image_mem_info, image_view_info);
+        image_frame_state->image_mem_offset = suballocations[frame_index].offset - image_mem_offset;
+        image_frame_state->suballocation    = suballocations[frame_index].block_index;
+    }
+
+    g_defragmenter.stats.image_move_count += 1;
+    g_defragmenter.stats.moved_bytes += image_state->size * image_state->frame_count;
+    return true;
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitDefragmenter(Allocator* allocator, DefragmenterInfo* info)
+{
+    VkDevice device = GetDevice();
+    uint32 frame_count = GetFrameCount();
+    CTK_ASSERT(frame_count <= 32); // Dirty descriptor frames are tracked with a 32-bit mask.
+
+    g_defragmenter.enabled             = true;
+    g_defragmenter.max_moves_per_frame = info->max_moves_per_frame;
+    g_defragmenter.command_pool        = CreateUploadCommandPool(device, GetPhysicalDevice()->queue_families.graphics);
+    g_defragmenter.command_buffers     = CreateArray<VkCommandBuffer>(allocator, frame_count);
+    for (uint32 frame_index = 0; frame_index < frame_count; ++frame_index)
+    {
+        Push(&g_defragmenter.command_buffers, AllocateUploadCommandBuffer(device, g_defragmenter.command_pool));
+    }
+    g_defragmenter.recording               = false;
+    g_defragmenter.pending_moves           = CreateArray<DefragMove>(allocator, info->max_pending_moves);
+    g_defragmenter.dirty_descriptor_frames = 0;
+    g_defragmenter.group_index             = UNSET_INDEX;
+    g_defragmenter.next_buffer_index       = 0;
+    g_defragmenter.next_image_index        = 0;
+    g_defragmenter.stats                   = {};
+}
+
+// Moves up to max_moves_per_frame of group's sub-buffers and images toward the start of their memory, copying their
+// contents with the current frame's commands. Must be called after AcquireSwapchainImage() and before any commands
+// referencing the group's resources are recorded for the current frame. Resources moved this frame must not be written
+// by uploads until the current frame completes. Returns number of resources moved.
+static uint32 DefragmentResourceGroup(ResourceGroupHnd res_group_hnd)
+{
+    if (!g_defragmenter.enabled)
+    {
+        return 0;
+    }
+
+    // Uploads write resources from the transfer queue at their current offsets, so resources stay put while any are
+    // in flight.
+    if (!UploadsIdle())
+    {
+        return 0;
+    }
+
+    ResourceGroup* res_group = GetResourceGroup(res_group_hnd.index);
+    if (g_defragmenter.group_index != res_group_hnd.index)
+    {
+        g_defragmenter.group_index       = res_group_hnd.index;
+        g_defragmenter.next_buffer_index = 0;
+        g_defragmenter.next_image_index  = 0;
+    }
+
+    // Continue from where last frame's budget ran out, visiting each resource at most once.
+    uint32 move_count = 0;
+    uint32 max_frame_moves = res_group->frame_count;
+    for (uint32 i = 0; i < res_group->buffer_count && move_count < g_defragmenter.max_moves_per_frame; ++i)
+    {
+        if (!CanPush(&g_defragmenter.pending_moves, max_frame_moves))
+        {
+            break;
+        }
+        uint32 buffer_index = g_defragmenter.next_buffer_index % res_group->buffer_count;
+        g_defragmenter.next_buffer_index = buffer_index + 1;
+        move_count += MoveBuffer(res_group, res_group_hnd.index, buffer_index) ? 1 : 0;
+    }
+    for (uint32 i = 0; i < res_group->image_count && move_count < g_defragmenter.max_moves_per_frame; ++i)
+    {
+        if (!CanPush(&g_defragmenter.pending_moves, max_frame_moves))
+        {
+            break;
+        }
+        uint32 image_index = g_defragmenter.next_image_index % res_group->image_count;
+        g_defragmenter.next_image_index = image_index + 1;
+        move_count += MoveImage(res_group, res_group_hnd.index, image_index) ? 1 : 0;
+    }
+
+    // Current frame's descriptor sets are no longer in use, so they're rewritten now. Other frames' sets are rewritten
+    // once their frames complete.
+    if (move_count > 0)
+    {
+        uint32 frame_index = GetFrameIndex();
+        WriteDescriptorSets(frame_index);
+        g_defragmenter.dirty_descriptor_frames = ((1u << GetFrameCount()) - 1) & ~(1u << frame_index);
+    }
+
+    return move_count;
+}
+
+// Ends current frame's defragmentation commands, returning true if any were recorded. Called by SubmitRenderCommands().
+static bool EndDefragCommands(VkCommandBuffer* command_buffer)
+{
+    if (!g_defragmenter.recording)
+    {
+        return false;
+    }
+
+    // Make copies visible to all later commands.
+    *command_buffer = Get(&g_defragmenter.command_buffers, GetFrameIndex());
+    VkMemoryBarrier barrier =
+    {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext         = NULL,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+    };
+    vkCmdPipelineBarrier(*command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,     // Source Stage Mask
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // Destination Stage Mask
+                         0,                                  // Dependency Flags
+                         1, &barrier,                        // Memory Barriers
+                         0, NULL,                            // Buffer Memory Barriers
+                         0, NULL);                           // Image Memory Barriers
+    VkResult res = vkEndCommandBuffer(*command_buffer);
+    Validate(res, "vkEndCommandBuffer() failed");
+    g_defragmenter.recording = false;
+
+    return true;
+}
+
+// Frees old ranges of moves whose frames have completed and rewrites current frame's descriptor sets if they reference
+// moved resources. Called by AcquireSwapchainImage() once current frame's previous commands have completed.
+static void ReleaseDefragMoves()
+{
+    if (!g_defragmenter.enabled)
+    {
+        return;
+    }
+
+    VkDevice device = GetDevice();
+    uint64 completed_frame_value = GetCompletedFrameValue();
+    uint32 remaining_count = 0;
+    for (uint32 i = 0; i < g_defragmenter.pending_moves.count; ++i)
+    {
+        DefragMove* move = GetPtr(&g_defragmenter.pending_moves, i);
+        if (move->frame_value > completed_frame_value)
+        {
+            Set(&g_defragmenter.pending_moves, remaining_count, *move);
+            ++remaining_count;
+            continue;
+        }
+
+        if (move->suballocator != NULL)
+        {
+            VkDeviceSize extent = GetSuballocatorExtent(move->suballocator);
+            FreeSuballocation(move->suballocator, move->block_index);
+            g_defragmenter.stats.reclaimed_bytes += extent - GetSuballocatorExtent(move->suballocator);
+        }
+        if (move->image != VK_NULL_HANDLE)
+        {
+            vkDestroyImageView(device, move->view, NULL);
+            vkDestroyImage(device, move->image, NULL);
+        }
+    }
+    g_defragmenter.pending_moves.count = remaining_count;
+
+    uint32 frame_bit = 1u << GetFrameIndex();
+    if (g_defragmenter.dirty_descriptor_frames & frame_bit)
+    {
+        WriteDescriptorSets(GetFrameIndex());
+        g_defragmenter.dirty_descriptor_frames &= ~frame_bit;
+    }
+}
+
+static void DropDefragmenterMoves(uint32 group_index, bool destroy_images)
+{
+    // Group's suballocators are reset along with the group, so old ranges are never freed. Old images are destroyed
+    // immediately if the group was deallocated, or once their frame completes if it was retired.
+    VkDevice device = GetDevice();
+    uint32 remaining_count = 0;
+    for (uint32 i = 0; i < g_defragmenter.pending_moves.count; ++i)
+    {
+        DefragMove* move = GetPtr(&g_defragmenter.pending_moves, i);
+        if (move->group_index == group_index)
+        {
+            if (move->image == VK_NULL_HANDLE)
+            {
+                continue;
+            }
+            if (destroy_images)
+            {
+                vkDestroyImageView(device, move->view, NULL);
+                vkDestroyImage(device, move->image, NULL);
+                continue;
+            }
+            move->suballocator = NULL;
+        }
+        Set(&g_defragmenter.pending_moves, remaining_count, *move);
+        ++remaining_count;
+    }
+    g_defragmenter.pending_moves.count = remaining_count;
+}
+
+static DefragStats* GetDefragStats()
+{
+    return &g_defragmenter.stats;
+}
+
+/// Debug
+////////////////////////////////////////////////////////////
+static void LogDefragStats()
+{
+    DefragStats* stats = &g_defragmenter.stats;
+    PrintLine("defragmenter:");
+    PrintLine("    buffer moves:    %llu", stats->buffer_move_count);
+    PrintLine("    image moves:     %llu", stats->image_move_count);
+    PrintLine("    moved bytes:     %llu", stats->moved_bytes);
+    PrintLine("    reclaimed bytes: %llu", stats->reclaimed_bytes);
+    PrintLine("    pending moves:   %u",   g_defragmenter.pending_moves.count);
+}
@@ -28,7 +28,7 @@ struct DescriptorState
     VkDescriptorSet*       sets;
     VkDescriptorPool       pool;
     uint32                 max_sets;
-    uint32                 set_count;
+    std::atomic<uint32>    set_count; // Sets can be created from worker threads; read once creation is done.
     uint32                 frame_count;
 };
 
@@ -39,6 +39,114 @@ struct DescriptorSetModuleInfo
 
 static DescriptorState g_desc_state;
 
+/// Utils
+////////////////////////////////////////////////////////////
+// Writes resources from data bindings to frame's descriptor sets, which must not be in use by in-flight commands.
+static void WriteDescriptorSets(uint32 frame_index)
+{
+    CTK::Frame frame = CreateFrame();
+
+    // Add up total number of data bindings for all descriptor sets.
+    uint32 buffer_write_count = 0;
+    uint32 image_write_count  = 0;
+    CTK_ITER_PTR(data_bindings, g_desc_state.data_bindings, g_desc_state.set_count.load())
+    {
+        CTK_ITER(data_binding, data_bindings)
+        {
+            if (data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+            {
+                buffer_write_count += data_binding->count;
+            }
+            else if (data_binding->type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+                     data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
+                     data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLER)
+            {
+                image_write_count += data_binding->count;
+            }
+            else
+            {
+                CTK_FATAL("unhandled descriptor type: %u", (uint32)data_binding->type);
+            }
+        }
+    }
+
+    // Generate writes from data bindings.
+    auto buffer_infos = CreateArray<VkDescriptorBufferInfo>(&frame, buffer_write_count);
+    auto image_infos  = CreateArray<VkDescriptorImageInfo> (&frame, image_write_count);
+    auto writes       = CreateArray<VkWriteDescriptorSet>  (&frame, buffer_infos.size + image_infos.size);
+    uint32 frame_offset = frame_index * g_desc_state.set_count;
+    for (uint32 set_index = 0; set_index < g_desc_state.set_count; ++set_index)
+    {
+        Array<DescriptorData>* data_bindings = &g_desc_state.data_bindings[set_index];
+        VkDescriptorSet descriptor_set = g_desc_state.sets[frame_offset + set_index];
+        for (uint32 binding_index = 0; binding_index < data_bindings->count; ++binding_index)
+        {
+            DescriptorData* data_binding = GetPtr(data_bindings, binding_index);
+            VkWriteDescriptorSet* write = Push(&writes);
+            write->sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write->dstSet          = descriptor_set;
+            write->dstBinding      = binding_index;
+            write->dstArrayElement = 0;
+            write->descriptorType  = data_binding->type;
+            write->descriptorCount = data_binding->count;
+
+            if (data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+                data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+            {
+                write->pBufferInfo = IterEnd(&buffer_infos);
+                CTK_ITER_PTR(buffer_hnd, data_binding->buffer_hnds, data_binding->count)
+                {
+                    VkDescriptorBufferInfo* desc_buffer_info = Push(&buffer_infos);
+                    desc_buffer_info->buffer = GetBuffer(*buffer_hnd);
+                    desc_buffer_info->offset = GetBufferFrameState(*buffer_hnd, frame_index)->res_mem_offset;
+                    desc_buffer_info->range  = GetBufferState(*buffer_hnd)->size;
+                }
+            }
+            else if (data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLER)
+            {
+                write->pImageInfo = IterEnd(&image_infos);
+                CTK_ITER_PTR(sampler, data_binding->samplers, data_binding->count)
+                {
+                    VkDescriptorImageInfo* desc_image_info = Push(&image_infos);
+                    desc_image_info->sampler     = *sampler;
+                    desc_image_info->imageView   = VK_NULL_HANDLE;
+                    desc_image_info->imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                }
+            }
+            else if (data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)
+            {
+                write->pImageInfo = IterEnd(&image_infos);
+                CTK_ITER_PTR(image_hnd, data_binding->image_hnds, data_binding->count)
+                {
+                    VkDescriptorImageInfo* desc_image_info = Push(&image_infos);
+                    desc_image_info->sampler     = VK_NULL_HANDLE;
+                    desc_image_info->imageView   = GetImageView(*image_hnd, frame_index);
+                    desc_image_info->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                }
+            }
+            else if (data_binding->type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+            {
+                write->pImageInfo = IterEnd(&image_infos);
+                CTK_ITER_PTR(image_hnd, data_binding->image_samplers.image_hnds, data_binding->count)
+                {
+                    VkDescriptorImageInfo* desc_image_info = Push(&image_infos);
+                    desc_image_info->sampler     = data_binding->image_samplers.sampler;
+                    desc_image_info->imageView   = GetImageView(*image_hnd, frame_index);
+                    desc_image_info->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                }
+            }
+            else
+            {
+                CTK_FATAL("unhandled descriptor type: %u", (uint32)data_binding->type);
+            }
+        }
+    }
+
+    // Update frame's descriptor sets with writes from data bindings.
+    vkUpdateDescriptorSets(GetDevice(), writes.count, writes.data, 0, NULL);
+}
+
 /// Interface
 ////////////////////////////////////////////////////////////
 static void InitDescriptorSetModule(Allocator* allocator, DescriptorSetModuleInfo info)
@@ -53,19 +161,18 @@ static void InitDescriptorSetModule(Allocator* allocator, DescriptorSetModuleInf
     g_desc_state.frame_count   = frame_count;
 }
 
+// Allocator must only be used by the calling thread when creating sets from multiple threads.
 static DescriptorSetHnd CreateDescriptorSet(Allocator* allocator, Array<DescriptorData> datas)
 {
-    if (g_desc_state.set_count >= g_desc_state.max_sets)
+    // Assign handle; slot is reserved with a single atomic add so creating threads never wait on each other.
+    DescriptorSetHnd hnd = { .index = g_desc_state.set_count.fetch_add(1) };
+    if (hnd.index >= g_desc_state.max_sets)
     {
         CTK_FATAL("can't create descriptor set: already at max of %u", g_desc_state.max_sets);
     }
 
     CTK::Frame frame = CreateFrame();
 
-    // Assign handle.
-    DescriptorSetHnd hnd = { .index = g_desc_state.set_count };
-    ++g_desc_state.set_count;
-
     // Copy data bindings.
     g_desc_state.data_bindings[hnd.index] = CreateArray<DescriptorData>(allocator, &datas);
 
@@ -101,7 +208,6 @@ static DescriptorSetHnd CreateDescriptorSet(Allocator* allocator, Array<Descript
 
 static void InitDescriptorSets()
 {
-    CTK::Frame frame = CreateFrame();
     VkDevice device = GetDevice();
     uint32 frame_count = g_desc_state.frame_count;
 
@@ -118,7 +224,7 @@ static void InitDescriptorSets()
         *pool_size_index = UINT32_MAX;
     }
 
-    CTK_ITER_PTR(data_bindings, g_desc_state.data_bindings, g_desc_state.set_count)
+    CTK_ITER_PTR(data_bindings, g_desc_state.data_bindings, g_desc_state.set_count.load())
     {
         CTK_ITER(data_binding, data_bindings)
         {
@@ -156,112 +262,11 @@ static void InitDescriptorSets()
         Validate(res, "vkAllocateDescriptorSets() failed");
     }
 
-    ///
-    /// Bind Resources
-    ///
-
-    // Add up total number of data bindings for all descriptor sets.
-    uint32 buffer_write_count = 0;
-    uint32 image_write_count  = 0;
-    CTK_ITER_PTR(data_bindings, g_desc_state.data_bindings, g_desc_state.set_count)
-    {
-        CTK_ITER(data_binding, data_bindings)
-        {
-            if (data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-                data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
-            {
-                buffer_write_count += data_binding->count;
-            }
-            else if (data_binding->type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
-                     data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE ||
-                     data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLER)
-            {
-                image_write_count += data_binding->count;
-            }
-            else
-            {
-                CTK_FATAL("unhandled descriptor type: %u", (uint32)data_binding->type);
-            }
-        }
-    }
-
-    // Generate writes from data bindings.
-    auto buffer_infos = CreateArray<VkDescriptorBufferInfo>(&frame, buffer_write_count * frame_count);
-    auto image_infos  = CreateArray<VkDescriptorImageInfo> (&frame, image_write_count  * frame_count);
-    auto writes       = CreateArray<VkWriteDescriptorSet>  (&frame, buffer_infos.size + image_infos.size);
+    // Write resources to each frame's descriptor sets.
     for (uint32 frame_index = 0; frame_index < frame_count; ++frame_index)
     {
-        uint32 frame_offset = frame_index * g_desc_state.set_count;
-        for (uint32 set_index = 0; set_index < g_desc_state.set_count; ++set_index)
-        {
-            Array<DescriptorData>* data_bindings = &g_desc_state.data_bindings[set_index];
-            VkDescriptorSet descriptor_set = g_desc_state.sets[frame_offset + set_index];
-            for (uint32 binding_index = 0; binding_index < data_bindings->count; ++binding_index)
-            {
-                DescriptorData* data_binding = GetPtr(data_bindings, binding_index);
-                VkWriteDescriptorSet* write = Push(&writes);
-                write->sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                write->dstSet          = descriptor_set;
-                write->dstBinding      = binding_index;
-                write->dstArrayElement = 0;
-                write->descriptorType  = data_binding->type;
-                write->descriptorCount = data_binding->count;
-
-                if (data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
-                    data_binding->type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
-                {
-                    write->pBufferInfo = IterEnd(&buffer_infos);
-                    CTK_ITER_PTR(buffer_hnd, data_binding->buffer_hnds, data_binding->count)
-                    {
-                        VkDescriptorBufferInfo* desc_buffer_info = Push(&buffer_infos);
-                        desc_buffer_info->buffer = GetBuffer(*buffer_hnd);
-                        desc_buffer_info->offset = GetBufferFrameState(*buffer_hnd, frame_index)->res_mem_offset;
-                        desc_buffer_info->range  = GetBufferState(*buffer_hnd)->size;
-                    }
-                }
-                else if (data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLER)
-                {
-                    write->pImageInfo = IterEnd(&image_infos);
-                    CTK_ITER_PTR(sampler, data_binding->samplers, data_binding->count)
-                    {
-                        VkDescriptorImageInfo* desc_image_info = Push(&image_infos);
-                        desc_image_info->sampler     = *sampler;
-                        desc_image_info->imageView   = VK_NULL_HANDLE;
-                        desc_image_info->imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-                    }
-                }
-                else if (data_binding->type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)
-                {
-                    write->pImageInfo = IterEnd(&image_infos);
-                    CTK_ITER_PTR(image_hnd, data_binding->image_hnds, data_binding->count)
-                    {
-                        VkDescriptorImageInfo* desc_image_info = Push(&image_infos);
-                        desc_image_info->sampler     = VK_NULL_HANDLE;
-                        desc_image_info->imageView   = GetImageView(*image_hnd, frame_index);
-                        desc_image_info->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    }
-                }
-                else if (data_binding->type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
-                {
-                    write->pImageInfo = IterEnd(&image_infos);
-                    CTK_ITER_PTR(image_hnd, data_binding->image_samplers.image_hnds, data_binding->count)
-                    {
-                        VkDescriptorImageInfo* desc_image_info = Push(&image_infos);
-                        desc_image_info->sampler     = data_binding->image_samplers.sampler;
-                        desc_image_info->imageView   = GetImageView(*image_hnd, frame_index);
-                        desc_image_info->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    }
-                }
-                else
-                {
-                    CTK_FATAL("unhandled descriptor type: %u", (uint32)data_binding->type);
-                }
-            }
-        }
+        WriteDescriptorSets(frame_index);
     }
-
-    // Update all descriptor sets with writes from data bindings.
-    vkUpdateDescriptorSets(GetDevice(), writes.count, writes.data, 0, NULL);
 }
 
 static VkDescriptorSetLayout GetLayout(DescriptorSetHnd hnd)
@@ -269,7 +274,7 @@ static VkDescriptorSetLayout GetLayout(DescriptorSetHnd hnd)
     if (hnd.index >= g_desc_state.set_count)
     {
         CTK_FATAL("can't get descriptor set layout: handle index %u exceeds descriptor set count of %u",
-                  hnd.index, g_desc_state.set_count);
+                  hnd.index, g_desc_state.set_count.load());
     }
     return g_desc_state.layouts[hnd.index];
 }
@@ -279,7 +284,7 @@ static VkDescriptorSet GetFrameSet(DescriptorSetHnd hnd, uint32 frame_index)
     if (hnd.index >= g_desc_state.set_count)
     {
         CTK_FATAL("can't get frame descriptor set: handle index %u exceeds descriptor set count of %u",
-                  hnd.index, g_desc_state.set_count);
+                  hnd.index, g_desc_state.set_count.load());
     }
 
     if (frame_index >= g_desc_state.frame_count)
@@ -2,7 +2,7 @@
 ////////////////////////////////////////////////////////////
 struct FrameMetrics
 {
-    clock_t start;
+    uint64  start_ns;
     float64 fps_update_freq;
     uint32  frame_count;
     float64 fps;
@@ -12,19 +12,20 @@ struct FrameMetrics
 ////////////////////////////////////////////////////////////
 static void InitFrameMetrics(FrameMetrics* frame_metrics, float64 fps_update_freq)
 {
-    frame_metrics->start = clock();
+    frame_metrics->start_ns = GetTimeNS();
     frame_metrics->fps_update_freq = fps_update_freq;
 }
 
 static bool Tick(FrameMetrics* frame_metrics)
 {
-    clock_t end = clock();
-    float64 elapsed_time = (float64)(end - frame_metrics->start) / CLOCKS_PER_SEC;
+    // Wall-clock time; clock() measures process CPU time, which overcounts when multiple threads are running.
+    uint64 end_ns = GetTimeNS();
+    float64 elapsed_time = (float64)(end_ns - frame_metrics->start_ns) / 1000000000.0;
     ++frame_metrics->frame_count;
     if (elapsed_time > frame_metrics->fps_update_freq)
     {
         frame_metrics->fps = frame_metrics->frame_count / elapsed_time;
-        frame_metrics->start = end;
+        frame_metrics->start_ns = end_ns;
         frame_metrics->frame_count = 0;
         return true;
     }
@@ -33,3 +34,238 @@ static bool Tick(FrameMetrics* frame_metrics)
         return false;
     }
 }
+
+/// Frame Stats Data
+////////////////////////////////////////////////////////////
+struct FrameStageInfo
+{
+    const char* name;
+    float64     budget_ms; // Stage times over budget are counted as hitches.
+};
+
+struct FrameStatsInfo
+{
+    float64               frame_budget_ms;
+    float64               bucket_width_ms; // Histogram resolution; percentiles are accurate to within a bucket.
+    uint32                bucket_count;    // Times past the last bucket are counted in an overflow bucket.
+    Array<FrameStageInfo> stages;          // CPU stages timed within each frame, in addition to built-in frame stage.
+};
+
+struct FrameStage
+{
+    const char*   name;
+    float64       budget_ms;
+    Array<uint32> histogram; // bucket_count buckets + overflow bucket.
+    uint64        sample_count;
+    float64       total_ms;
+    float64       max_ms;
+    uint32        hitch_count;
+};
+
+struct FrameStageReport
+{
+    uint64  sample_count;
+    float64 avg_ms;
+    float64 p50_ms;
+    float64 p90_ms;
+    float64 p99_ms;
+    float64 p999_ms;
+    float64 max_ms;
+    uint32  hitch_count;
+};
+
+// Fixed-memory frame-time recorder; histograms accumulate until reset so runs can be compared as a whole.
+struct FrameStats
+{
+    float64           bucket_width_ms;
+    Array<FrameStage> stages; // Stage 0 is the whole frame.
+    uint64            frame_start_ns;
+};
+
+static constexpr uint32 FRAME_STAGE_INDEX = 0;
+
+/// Frame Stats Utils
+////////////////////////////////////////////////////////////
+static float64 GetHistogramPercentile(FrameStats* frame_stats, FrameStage* stage, float64 percentile)
+{
+    // Find first bucket where cumulative count reaches percentile rank, then report bucket's upper bound (clamped to
+    // max, which is also used for the overflow bucket).
+    float64 exact_rank = percentile * (float64)stage->sample_count;
+    uint64 rank = (uint64)exact_rank;
+    if ((float64)rank < exact_rank || rank == 0)
+    {
+        ++rank;
+    }
+    uint64 cumulative_count = 0;
+    uint32 overflow_bucket_index = stage->histogram.count - 1;
+    for (uint32 bucket_index = 0; bucket_index < overflow_bucket_index; ++bucket_index)
+    {
+        cumulative_count += Get(&stage->histogram, bucket_index);
+        if (cumulative_count >= rank)
+        {
+            float64 bucket_upper_ms = (float64)(bucket_index + 1) * frame_stats->bucket_width_ms;
+            return bucket_upper_ms < stage->max_ms ? bucket_upper_ms : stage->max_ms;
+        }
+    }
+    return stage->max_ms;
+}
+
+static void PushFrameStage(FrameStats* frame_stats, Allocator* allocator, FrameStageInfo* stage_info,
+                           uint32 bucket_count)
+{
+    FrameStage* stage = Push(&frame_stats->stages);
+    stage->name         = stage_info->name;
+    stage->budget_ms    = stage_info->budget_ms;
+    stage->histogram    = CreateArrayFull<uint32>(allocator, bucket_count + 1);
+    stage->sample_count = 0;
+    stage->total_ms     = 0.0;
+    stage->max_ms       = 0.0;
+    stage->hitch_count  = 0;
+    memset(stage->histogram.data, 0, stage->histogram.count * sizeof(uint32));
+}
+
+/// Frame Stats Interface
+////////////////////////////////////////////////////////////
+static void InitFrameStats(FrameStats* frame_stats, Allocator* allocator, FrameStatsInfo* info)
+{
+    frame_stats->bucket_width_ms = info->bucket_width_ms;
+    frame_stats->stages          = CreateArray<FrameStage>(allocator, info->stages.count + 1);
+    frame_stats->frame_start_ns  = 0;
+
+    FrameStageInfo frame_stage_info = { .name = "frame", .budget_ms = info->frame_budget_ms };
+    PushFrameStage(frame_stats, allocator, &frame_stage_info, info->bucket_count);
+    CTK_ITER(stage_info, &info->stages)
+    {
+        PushFrameStage(frame_stats, allocator, stage_info, info->bucket_count);
+    }
+}
+
+static void ResetFrameStats(FrameStats* frame_stats)
+{
+    CTK_ITER(stage, &frame_stats->stages)
+    {
+        memset(stage->histogram.data, 0, stage->histogram.count * sizeof(uint32));
+        stage->sample_count = 0;
+        stage->total_ms     = 0.0;
+        stage->max_ms       = 0.0;
+        stage->hitch_count  = 0;
+    }
+    frame_stats->frame_start_ns = 0;
+}
+
+static void RecordFrameStageTime(FrameStats* frame_stats, uint32 stage_index, float64 ms)
+{
+    FrameStage* stage = GetPtr(&frame_stats->stages, stage_index);
+    uint32 overflow_bucket_index = stage->histogram.count - 1;
+    uint32 bucket_index = (uint32)(ms / frame_stats->bucket_width_ms);
+    ++(*GetPtr(&stage->histogram, bucket_index < overflow_bucket_index ? bucket_index : overflow_bucket_index));
+    ++stage->sample_count;
+    stage->total_ms += ms;
+    stage->max_ms = Max(stage->max_ms, ms);
+    if (ms > stage->budget_ms)
+    {
+        ++stage->hitch_count;
+    }
+}
+
+// Records time elapsed since start_ns (from GetTimeNS()) for stage.
+static void RecordFrameStage(FrameStats* frame_stats, uint32 stage_index, uint64 start_ns)
+{
+    RecordFrameStageTime(frame_stats, stage_index, GetElapsedMS(start_ns));
+}
+
+// Records frame time as time between consecutive calls; the first call only starts timing.
+static void TickFrameStats(FrameStats* frame_stats)
+{
+    uint64 now_ns = GetTimeNS();
+    if (frame_stats->frame_start_ns != 0)
+    {
+        RecordFrameStageTime(frame_stats, FRAME_STAGE_INDEX,
+                             (float64)(now_ns - frame_stats->frame_start_ns) / 1000000.0);
+    }
+    frame_stats->frame_start_ns = now_ns;
+}
+
+static void GetFrameStageReport(FrameStageReport* report, FrameStats* frame_stats, uint32 stage_index)
+{
+    FrameStage* stage = GetPtr(&frame_stats->stages, stage_index);
+    *report = {};
+    if (stage->sample_count == 0)
+    {
+        return;
+    }
+
+    report->sample_count = stage->sample_count;
+    report->avg_ms       = stage->total_ms / (float64)stage->sample_count;
+    report->p50_ms       = GetHistogramPercentile(frame_stats, stage, 0.50);
+    report->p90_ms       = GetHistogramPercentile(frame_stats, stage, 0.90);
+    report->p99_ms       = GetHistogramPercentile(frame_stats, stage, 0.99);
+    report->p999_ms      = GetHistogramPercentile(frame_stats, stage, 0.999);
+    report->max_ms       = stage->max_ms;
+    report->hitch_count  = stage->hitch_count;
+}
+
+static void LogFrameStats(FrameStats* frame_stats)
+{
+    PrintLine("frame stats (ms):");
+    for (uint32 stage_index = 0; stage_index < frame_stats->stages.count; ++stage_index)
+    {
+        FrameStageReport report = {};
+        GetFrameStageReport(&report, frame_stats, stage_index);
+        PrintLine("    %-24s avg: %7.3f  p50: %7.3f  p90: %7.3f  p99: %7.3f  p99.9: %7.3f  max: %7.3f  hitches: %u",
+                  GetPtr(&frame_stats->stages, stage_index)->name, report.avg_ms, report.p50_ms, report.p90_ms,
+                  report.p99_ms, report.p999_ms, report.max_ms, report.hitch_count);
+    }
+}
+
+static void WriteFrameStatsCSV(FrameStats* frame_stats, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        PrintWarning("failed to open frame stats file \"%s\" for writing", path);
+        return;
+    }
+
+    fprintf(file, "stage,budget_ms,samples,avg_ms,p50_ms,p90_ms,p99_ms,p999_ms,max_ms,hitches\n");
+    for (uint32 stage_index = 0; stage_index < frame_stats->stages.count; ++stage_index)
+    {
+        FrameStage* stage = GetPtr(&frame_stats->stages, stage_index);
+        FrameStageReport report = {};
+        GetFrameStageReport(&report, frame_stats, stage_index);
+        fprintf(file, "%s,%.3f,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%u\n",
+                stage->name, stage->budget_ms, (unsigned long long)report.sample_count, report.avg_ms, report.p50_ms,
+                report.p90_ms, report.p99_ms, report.p999_ms, report.max_ms, report.hitch_count);
+    }
+    fclose(file);
+}
+
+static void WriteFrameStatsJSON(FrameStats* frame_stats, const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        PrintWarning("failed to open frame stats file \"%s\" for writing", path);
+        return;
+    }
+
+    fprintf(file, "{\n  \"bucket_width_ms\": %.3f,\n  \"stages\": [\n", frame_stats->bucket_width_ms);
+    for (uint32 stage_index = 0; stage_index < frame_stats->stages.count; ++stage_index)
+    {
+        FrameStage* stage = GetPtr(&frame_stats->stages, stage_index);
+        FrameStageReport report = {};
+        GetFrameStageReport(&report, frame_stats, stage_index);
+        fprintf(file, "    { \"name\": \"%s\", \"budget_ms\": %.3f, \"samples\": %llu, \"avg_ms\": %.3f, "
+                      "\"p50_ms\": %.3f, \"p90_ms\": %.3f, \"p99_ms\": %.3f, \"p999_ms\": %.3f, \"max_ms\": %.3f, "
+                      "\"hitches\": %u, \"histogram\": [",
+                stage->name, stage->budget_ms, (unsigned long long)report.sample_count, report.avg_ms,
+                report.p50_ms, report.p90_ms, report.p99_ms, report.p999_ms, report.max_ms, report.hitch_count);
+        for (uint32 bucket_index = 0; bucket_index < stage->histogram.count; ++bucket_index)
+        {
+            fprintf(file, "%s%u", bucket_index == 0 ? "" : ",", Get(&stage->histogram, bucket_index));
+        }
+        fprintf(file, "] }%s\n", stage_index + 1 < frame_stats->stages.count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+}
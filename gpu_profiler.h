@@ -0,0 +1,375 @@
+/// Data
+////////////////////////////////////////////////////////////
+struct GPUScopeHnd    { uint32 index; };
+struct GPUScopeRecord { uint32 scope_index; uint32 query_index; }; // query_index is begin query; end query follows it.
+
+struct GPUProfilerInfo
+{
+    uint32 max_scopes;
+    uint32 max_records_per_thread; // Max scopes recorded by a single thread each frame.
+    uint32 sample_count;           // Number of frames rolling stats are calculated over.
+};
+
+struct GPUScope
+{
+    const char*    name;
+    Array<float64> samples; // Ring of per-frame durations in milliseconds.
+    uint32         next_sample_index;
+
+    // Span of all records of scope in a frame, from earliest begin to latest end, so records from concurrent threads
+    // aren't double counted. Begin and end are timestamp offsets from frame_reference (see GetGPUTimestampOffset()).
+    uint64         frame_reference;
+    uint64         frame_begin;
+    uint64         frame_end;
+    bool           recorded;
+};
+
+struct GPUScopeStats
+{
+    uint32  sample_count;
+    float64 avg_ms;
+    float64 min_ms;
+    float64 max_ms;
+    float64 p50_ms;
+    float64 p95_ms;
+    float64 p99_ms;
+};
+
+struct GPUProfilerFrame
+{
+    VkQueryPool           query_pool;
+    Array<GPUScopeRecord> records;      // Partitioned into max_records_per_thread sized ranges for each thread.
+    Array<uint32>         record_counts; // Number of records in each thread's range.
+};
+
+struct GPUProfiler
+{
+    bool                    enabled;
+    uint32                  thread_count; // Render threads + main thread, which records into primary command buffers.
+    uint32                  max_records_per_thread;
+    uint32                  sample_count;
+    float64                 timestamp_period; // Nanoseconds per timestamp tick.
+    uint64                  timestamp_mask;
+    Array<GPUScope>         scopes;
+    Array<GPUProfilerFrame> frames;
+    Array<uint64>           query_results;
+    Array<float64>          sorted_samples; // Scratch space for calculating percentiles.
+    GPUScopeHnd             frame_scope;
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static GPUProfiler g_gpu_profiler;
+
+/// Utils
+////////////////////////////////////////////////////////////
+static int CompareSamples(const void* a, const void* b)
+{
+    float64 sample_a = *(float64*)a;
+    float64 sample_b = *(float64*)b;
+    return sample_a < sample_b ? -1 : sample_a > sample_b ? 1 : 0;
+}
+
+static float64 GetPercentile(float64* sorted_samples, uint32 sample_count, float64 percentile)
+{
+    uint32 index = (uint32)(percentile * (float64)(sample_count - 1) + 0.5);
+    return sorted_samples[index];
+}
+
+static GPUProfilerFrame* GetGPUProfilerFrame(uint32 frame_index)
+{
+    return GetPtr(&g_gpu_profiler.frames, frame_index);
+}
+
+static void PushGPUScopeSample(GPUScope* scope, float64 sample)
+{
+    if (scope->samples.count < scope->samples.size)
+    {
+        Push(&scope->samples, sample);
+    }
+    else
+    {
+        Set(&scope->samples, scope->next_sample_index, sample);
+    }
+    scope->next_sample_index = (scope->next_sample_index + 1) % scope->samples.size;
+}
+
+// Offset of timestamp from reference, biased by half the valid timestamp range so timestamps before reference still
+// compare lower after wrapping.
+static uint64 GetGPUTimestampOffset(uint64 timestamp, uint64 reference)
+{
+    uint64 half_range = (g_gpu_profiler.timestamp_mask >> 1) + 1;
+    return (timestamp - reference + half_range) & g_gpu_profiler.timestamp_mask;
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static GPUScopeHnd RegisterGPUScope(Stack* perm_stack, const char* name)
+{
+    if (!g_gpu_profiler.enabled)
+    {
+        return { .index = 0 };
+    }
+    if (!CanPush(&g_gpu_profiler.scopes))
+    {
+        CTK_FATAL("can't register GPU scope \"%s\": already at max GPU scopes of %u", name,
+                  g_gpu_profiler.scopes.size);
+    }
+
+    GPUScopeHnd scope_hnd = { .index = g_gpu_profiler.scopes.count };
+    Push(&g_gpu_profiler.scopes,
+    {
+        .name              = name,
+        .samples           = CreateArray<float64>(perm_stack, g_gpu_profiler.sample_count),
+        .next_sample_index = 0,
+        .frame_reference   = 0,
+        .frame_begin       = 0,
+        .frame_end         = 0,
+        .recorded          = false,
+    });
+    return scope_hnd;
+}
+
+static void InitGPUProfiler(Stack* perm_stack, GPUProfilerInfo* info)
+{
+    CTK::Frame frame = CreateFrame();
+
+    VkDevice device = GetDevice();
+    PhysicalDevice* physical_device = GetPhysicalDevice();
+
+    // Timestamps are only written if graphics queue supports them; profiler is left disabled otherwise so scopes can
+    // still be recorded unconditionally.
+    Array<VkQueueFamilyProperties> queue_family_props = {};
+    LoadVkQueueFamilyProperties(&queue_family_props, &frame, physical_device->hnd);
+    uint32 timestamp_valid_bits = Get(&queue_family_props, physical_device->queue_families.graphics)
+                                  .timestampValidBits;
+    if (timestamp_valid_bits == 0)
+    {
+        PrintWarning("GPU profiler disabled: graphics queue family doesn't support timestamps");
+        g_gpu_profiler.enabled = false;
+        return;
+    }
+
+    g_gpu_profiler.enabled                = true;
+    g_gpu_profiler.thread_count           = GetRenderThreadCount() + 1;
+    g_gpu_profiler.max_records_per_thread = info->max_records_per_thread;
+    g_gpu_profiler.sample_count           = info->sample_count;
+    g_gpu_profiler.timestamp_period       = physical_device->properties.limits.timestampPeriod;
+    g_gpu_profiler.timestamp_mask         = timestamp_valid_bits == 64 ? UINT64_MAX
+                                                                       : (1ull << timestamp_valid_bits) - 1;
+
+    // Scopes; +1 for built-in frame scope.
+    g_gpu_profiler.scopes         = CreateArray<GPUScope>(perm_stack, info->max_scopes + 1);
+    g_gpu_profiler.sorted_samples = CreateArrayFull<float64>(perm_stack, info->sample_count);
+
+    // Frames; each frame has its own query pool so results can be read back once the frame's commands complete
+    // without stalling on frames still in flight.
+    uint32 max_records = g_gpu_profiler.thread_count * info->max_records_per_thread;
+    uint32 query_count = max_records * 2;
+    g_gpu_profiler.query_results = CreateArrayFull<uint64>(perm_stack, query_count);
+    g_gpu_profiler.frames = CreateArray<GPUProfilerFrame>(perm_stack, GetFrameCount());
+    for (uint32 frame_index = 0; frame_index < GetFrameCount(); ++frame_index)
+    {
+        GPUProfilerFrame* profiler_frame = Push(&g_gpu_profiler.frames);
+        profiler_frame->records       = CreateArrayFull<GPUScopeRecord>(perm_stack, max_records);
+        profiler_frame->record_counts = CreateArrayFull<uint32>(perm_stack, g_gpu_profiler.thread_count);
+
+        VkQueryPoolCreateInfo query_pool_info =
+        {
+            .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext              = NULL,
+            .flags              = 0,
+            .queryType          = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount         = query_count,
+            .pipelineStatistics = 0,
+        };
+        VkResult res = vkCreateQueryPool(device, &query_pool_info, NULL, &profiler_frame->query_pool);
+        Validate(res, "vkCreateQueryPool() failed");
+
+        // Queries must be reset before first use; host reset is used so render passes don't need to be split.
+        vkResetQueryPool(device, profiler_frame->query_pool, 0, query_count);
+    }
+
+    // Built-in scope covering render pass recorded by SubmitRenderCommands().
+    g_gpu_profiler.frame_scope = RegisterGPUScope(perm_stack, "frame");
+}
+
+static bool GPUProfilerEnabled()
+{
+    return g_gpu_profiler.enabled;
+}
+
+static GPUScopeHnd GetGPUFrameScope()
+{
+    return g_gpu_profiler.frame_scope;
+}
+
+static GPUScopeRecord BeginGPUScope(VkCommandBuffer command_buffer, GPUScopeHnd scope_hnd, uint32 thread_index)
+{
+    GPUScopeRecord record = { .scope_index = scope_hnd.index, .query_index = UNSET_INDEX };
+    if (!g_gpu_profiler.enabled)
+    {
+        return record;
+    }
+
+    CTK_ASSERT(scope_hnd.index < g_gpu_profiler.scopes.count);
+    CTK_ASSERT(thread_index < g_gpu_profiler.thread_count);
+
+    // Each thread only writes to its own range of records and queries, so no synchronization is needed.
+    GPUProfilerFrame* profiler_frame = GetGPUProfilerFrame(GetFrameIndex());
+    uint32* record_count = GetPtr(&profiler_frame->record_counts, thread_index);
+    if (*record_count == g_gpu_profiler.max_records_per_thread)
+    {
+        return record; // Out of records; scope is dropped rather than failing mid-frame.
+    }
+
+    uint32 record_index = (thread_index * g_gpu_profiler.max_records_per_thread) + *record_count;
+    record.query_index = record_index * 2;
+    Set(&profiler_frame->records, record_index, record);
+    ++(*record_count);
+
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, profiler_frame->query_pool,
+                        record.query_index);
+    return record;
+}
+
+static void EndGPUScope(VkCommandBuffer command_buffer, GPUScopeRecord record)
+{
+    if (record.query_index == UNSET_INDEX)
+    {
+        return;
+    }
+
+    GPUProfilerFrame* profiler_frame = GetGPUProfilerFrame(GetFrameIndex());
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, profiler_frame->query_pool,
+                        record.query_index + 1);
+}
+
+// Reads back timestamps recorded the last time the current frame was in flight. Must only be called once the
+// current frame's previous commands have completed (see AcquireSwapchainImage()), so results are available
+// without waiting.
+static void ReadGPUProfilerResults()
+{
+    if (!g_gpu_profiler.enabled)
+    {
+        return;
+    }
+
+    VkDevice device = GetDevice();
+    GPUProfilerFrame* profiler_frame = GetGPUProfilerFrame(GetFrameIndex());
+    float64 ms_per_tick = g_gpu_profiler.timestamp_period / 1000000.0;
+
+    for (uint32 thread_index = 0; thread_index < g_gpu_profiler.thread_count; ++thread_index)
+    {
+        uint32 record_count = Get(&profiler_frame->record_counts, thread_index);
+        if (record_count == 0)
+        {
+            continue;
+        }
+
+        uint32 first_record_index = thread_index * g_gpu_profiler.max_records_per_thread;
+        uint32 first_query_index = first_record_index * 2;
+        uint32 query_count = record_count * 2;
+        VkResult res = vkGetQueryPoolResults(device, profiler_frame->query_pool, first_query_index, query_count,
+                                             query_count * sizeof(uint64), g_gpu_profiler.query_results.data,
+                                             sizeof(uint64), VK_QUERY_RESULT_64_BIT);
+        if (res == VK_NOT_READY)
+        {
+            // Only possible if a scope was begun without being submitted; drop thread's results for this frame.
+            continue;
+        }
+        Validate(res, "vkGetQueryPoolResults() failed");
+
+        for (uint32 i = 0; i < record_count; ++i)
+        {
+            GPUScopeRecord* record = GetPtr(&profiler_frame->records, first_record_index + i);
+            uint64 begin = Get(&g_gpu_profiler.query_results, (i * 2) + 0);
+            uint64 end   = Get(&g_gpu_profiler.query_results, (i * 2) + 1);
+            GPUScope* scope = GetPtr(&g_gpu_profiler.scopes, record->scope_index);
+            if (!scope->recorded)
+            {
+                scope->frame_reference = begin;
+                scope->frame_begin     = GetGPUTimestampOffset(begin, begin);
+                scope->frame_end       = GetGPUTimestampOffset(end,   begin);
+                scope->recorded        = true;
+                continue;
+            }
+            scope->frame_begin = Min(scope->frame_begin, GetGPUTimestampOffset(begin, scope->frame_reference));
+            scope->frame_end   = Max(scope->frame_end,   GetGPUTimestampOffset(end,   scope->frame_reference));
+        }
+    }
+
+    // Push one sample per scope recorded in frame, spanning all records of scope (e.g. one by each thread).
+    CTK_ITER(scope, &g_gpu_profiler.scopes)
+    {
+        if (scope->recorded)
+        {
+            uint64 ticks = (scope->frame_end - scope->frame_begin) & g_gpu_profiler.timestamp_mask;
+            PushGPUScopeSample(scope, (float64)ticks * ms_per_tick);
+        }
+        scope->recorded = false;
+    }
+
+    // Reset frame's queries and records for reuse.
+    vkResetQueryPool(device, profiler_frame->query_pool, 0, g_gpu_profiler.query_results.size);
+    CTK_ITER(record_count, &profiler_frame->record_counts)
+    {
+        *record_count = 0;
+    }
+}
+
+static void GetGPUScopeStats(GPUScopeStats* stats, GPUScopeHnd scope_hnd)
+{
+    *stats = {};
+    if (!g_gpu_profiler.enabled)
+    {
+        return;
+    }
+
+    GPUScope* scope = GetPtr(&g_gpu_profiler.scopes, scope_hnd.index);
+    uint32 sample_count = scope->samples.count;
+    if (sample_count == 0)
+    {
+        return;
+    }
+
+    // Sort copy of samples for percentiles.
+    float64* sorted_samples = g_gpu_profiler.sorted_samples.data;
+    memcpy(sorted_samples, scope->samples.data, sample_count * sizeof(float64));
+    qsort(sorted_samples, sample_count, sizeof(float64), CompareSamples);
+
+    float64 total_ms = 0.0;
+    for (uint32 i = 0; i < sample_count; ++i)
+    {
+        total_ms += sorted_samples[i];
+    }
+
+    stats->sample_count = sample_count;
+    stats->avg_ms       = total_ms / sample_count;
+    stats->min_ms       = sorted_samples[0];
+    stats->max_ms       = sorted_samples[sample_count - 1];
+    stats->p50_ms       = GetPercentile(sorted_samples, sample_count, 0.50);
+    stats->p95_ms       = GetPercentile(sorted_samples, sample_count, 0.95);
+    stats->p99_ms       = GetPercentile(sorted_samples, sample_count, 0.99);
+}
+
+/// Debug
+////////////////////////////////////////////////////////////
+static void LogGPUProfiler()
+{
+    if (!g_gpu_profiler.enabled)
+    {
+        return;
+    }
+
+    PrintLine("GPU scopes (ms):");
+    for (uint32 scope_index = 0; scope_index < g_gpu_profiler.scopes.count; ++scope_index)
+    {
+        GPUScopeStats stats = {};
+        GetGPUScopeStats(&stats, { .index = scope_index });
+        PrintLine("    %-16s avg: %7.3f  min: %7.3f  max: %7.3f  p50: %7.3f  p95: %7.3f  p99: %7.3f  (%u samples)",
+                  GetPtr(&g_gpu_profiler.scopes, scope_index)->name,
+                  stats.avg_ms, stats.min_ms, stats.max_ms, stats.p50_ms, stats.p95_ms, stats.p99_ms,
+                  stats.sample_count);
+    }
+}
@@ -19,14 +19,6 @@ struct ImageData
 
 /// Utils
 ////////////////////////////////////////////////////////////
-static void ValidateImage(ResourceGroup* res_group, uint32 image_index, const char* action)
-{
-    if (image_index >= res_group->image_count)
-    {
-        CTK_FATAL("%s: image index %u exceeds image count of %u", action, image_index, res_group->image_count);
-    }
-}
-
 /// Interface
 ////////////////////////////////////////////////////////////
 static void LoadImageData(ImageData* image_data, const char* path)
@@ -55,12 +47,12 @@ static void DestroyImageData(ImageData* image_data)
     *image_data = {};
 }
 
-static void LoadImage(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 frame_index,
-                      VkDeviceSize size, uint8* data, VkDeviceSize offset)
+static void UploadImageCmd(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 frame_index,
+                           VkDeviceSize staging_offset = 0)
 {
     ResourceGroup* res_group = GetResourceGroup(image_hnd.group_index);
-    ValidateImage(res_group, image_hnd.index, "can't load image");
-    ValidateBuffer(res_group, staging_buffer_hnd.index, "can't load image from buffer");
+    ValidateImage(res_group, image_hnd, "can't upload image");
+    ValidateBuffer(res_group, staging_buffer_hnd, "can't upload image from buffer");
 
     // Validate image's memory's format support linear filtering for mipmap generation.
     uint32 image_mem_index = GetImageState(res_group, image_hnd.index)->image_mem_index;
@@ -69,35 +61,83 @@ static void LoadImage(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 f
     vkGetPhysicalDeviceFormatProperties(GetPhysicalDevice()->hnd, image_format, &format_properties);
     if (!(format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
     {
-        CTK_FATAL("can't load image: image's memory's format properties do not support "
+        CTK_FATAL("can't upload image: image's memory's format properties do not support "
                   "VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT required for mipmap generation.");
     }
 
-    HostBufferWrite image_data_write =
-    {
-        .size       = size,
-        .src_data   = data,
-        .src_offset = offset,
-        .dst_hnd    = staging_buffer_hnd,
-    };
-    WriteHostBuffer(&image_data_write, frame_index);
-
-    // Copy image data from buffer memory to image memory.
+    // Copy image data from buffer memory to image memory on transfer queue, then generate mips on graphics queue as
+    // blits aren't supported by transfer-only queues.
     VkBuffer staging_buffer = GetBuffer(res_group, staging_buffer_hnd.index);
     VkImage image = GetImageFrameState(res_group, image_hnd.index, frame_index)->image;
     ImageInfo* image_info = GetImageInfo(res_group, image_hnd.index);
-    VkCommandBuffer temp_command_buffer = GetTempCommandBuffer();
-    BeginTempCommandBuffer();
-        // Transition all mip levels to transfer_write & transfer_dst.
-        VkImageMemoryBarrier transition_transfer_dst =
+    Upload* upload = GetCurrentUpload();
+    VkCommandBuffer transfer_command_buffer = upload->transfer_command_buffer;
+    VkCommandBuffer graphics_command_buffer = upload->graphics_command_buffer;
+    // Transition all mip levels to transfer_write & transfer_dst.
+    VkImageMemoryBarrier transition_transfer_dst =
+    {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask       = VK_ACCESS_NONE,
+        .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = image,
+        .subresourceRange =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount     = 1,
+        },
+    };
+    vkCmdPipelineBarrier(transfer_command_buffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // Source Stage Mask
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,    // Destination Stage Mask
+                         0,                                 // Dependency Flags
+                         0, NULL,                           // Memory Barriers
+                         0, NULL,                           // Buffer Memory Barriers
+                         1, &transition_transfer_dst);      // Image Memory Barriers
+
+    // Copy buffer data to image.
+    VkBufferImageCopy copy =
+    {
+        .bufferOffset      = GetBufferFrameState(staging_buffer_hnd, frame_index)->res_mem_offset + staging_offset,
+        .bufferRowLength   = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel       = 0,
+            .baseArrayLayer = 0,
+            .layerCount     = 1,
+        },
+        .imageOffset =
+        {
+            .x = 0,
+            .y = 0,
+            .z = 0,
+        },
+        .imageExtent = image_info->extent,
+    };
+    vkCmdCopyBufferToImage(transfer_command_buffer, staging_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1, &copy);
+
+    // Release all mip levels from transfer queue family and acquire them on graphics queue family.
+    if (RequiresOwnershipTransfer())
+    {
+        QueueFamilies* queue_families = &GetPhysicalDevice()->queue_families;
+        VkImageMemoryBarrier ownership_transfer =
         {
             .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-            .srcAccessMask       = VK_ACCESS_NONE,
-            .dstAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_NONE,
+            .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
             .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .srcQueueFamilyIndex = queue_families->transfer,
+            .dstQueueFamilyIndex = queue_families->graphics,
             .image               = image,
             .subresourceRange =
             {
@@ -108,171 +148,177 @@ static void LoadImage(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 f
                 .layerCount     = 1,
             },
         };
-        vkCmdPipelineBarrier(temp_command_buffer,
-                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, // Source Stage Mask
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,    // Destination Stage Mask
-                             0,                                 // Dependency Flags
-                             0, NULL,                           // Memory Barriers
-                             0, NULL,                           // Buffer Memory Barriers
-                             1, &transition_transfer_dst);      // Image Memory Barriers
+        vkCmdPipelineBarrier(transfer_command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,       // Source Stage Mask
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // Destination Stage Mask
+                             0,                                    // Dependency Flags
+                             0, NULL,                              // Memory Barriers
+                             0, NULL,                              // Buffer Memory Barriers
+                             1, &ownership_transfer);              // Image Memory Barriers
+
+        ownership_transfer.srcAccessMask = VK_ACCESS_NONE;
+        ownership_transfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(graphics_command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, // Source Stage Mask
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, // Destination Stage Mask
+                             0,                              // Dependency Flags
+                             0, NULL,                        // Memory Barriers
+                             0, NULL,                        // Buffer Memory Barriers
+                             1, &ownership_transfer);        // Image Memory Barriers
+    }
 
-        // Copy buffer data to image.
-        VkBufferImageCopy copy =
+    // Blit mip images.
+    sint32 mip_width  = image_info->extent.width;
+    sint32 mip_height = image_info->extent.height;
+    for (uint32 i = 1; i < image_info->mip_levels; i += 1)
+    {
+        // Transition previous mip level to transfer_read & transfer_src.
+        VkImageMemoryBarrier transition_prev_mip_level =
         {
-            .bufferOffset      = GetBufferFrameState(staging_buffer_hnd, frame_index)->res_mem_offset,
-            .bufferRowLength   = 0,
-            .bufferImageHeight = 0,
-            .imageSubresource =
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = image,
+            .subresourceRange =
             {
                 .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                .mipLevel       = 0,
+                .baseMipLevel   = i - 1,
+                .levelCount     = 1,
                 .baseArrayLayer = 0,
                 .layerCount     = 1,
             },
-            .imageOffset =
-            {
-                .x = 0,
-                .y = 0,
-                .z = 0,
-            },
-            .imageExtent = image_info->extent,
         };
-        vkCmdCopyBufferToImage(temp_command_buffer, staging_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                               1, &copy);
+        vkCmdPipelineBarrier(graphics_command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, // Source Stage Mask
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, // Destination Stage Mask
+                             0,                              // Dependency Flags
+                             0, NULL,                        // Memory Barriers
+                             0, NULL,                        // Buffer Memory Barriers
+                             1, &transition_prev_mip_level); // Image Memory Barriers
 
-        // Blit mip images.
-        sint32 mip_width  = image_info->extent.width;
-        sint32 mip_height = image_info->extent.height;
-        for (uint32 i = 1; i < image_info->mip_levels; i += 1)
+        sint32 half_mip_width  = Max(1, mip_width  / 2);
+        sint32 half_mip_height = Max(1, mip_height / 2);
+        VkImageBlit image_blit =
         {
-            // Transition previous mip level to transfer_read & transfer_src.
-            VkImageMemoryBarrier transition_prev_mip_level =
+            .srcSubresource =
             {
-                .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
-                .dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT,
-                .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image               = image,
-                .subresourceRange =
-                {
-                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .baseMipLevel   = i - 1,
-                    .levelCount     = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount     = 1,
-                },
-            };
-            vkCmdPipelineBarrier(temp_command_buffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT, // Source Stage Mask
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT, // Destination Stage Mask
-                                 0,                              // Dependency Flags
-                                 0, NULL,                        // Memory Barriers
-                                 0, NULL,                        // Buffer Memory Barriers
-                                 1, &transition_prev_mip_level); // Image Memory Barriers
-
-            sint32 half_mip_width  = Max(1, mip_width  / 2);
-            sint32 half_mip_height = Max(1, mip_height / 2);
-            VkImageBlit image_blit =
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel       = i - 1,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+            .srcOffsets =
+            {
+                { 0,         0,          0 },
+                { mip_width, mip_height, 1 },
+            },
+            .dstSubresource =
+            {
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel       = i,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+            .dstOffsets =
             {
-                .srcSubresource =
-                {
-                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .mipLevel       = i - 1,
-                    .baseArrayLayer = 0,
-                    .layerCount     = 1,
-                },
-                .srcOffsets =
-                {
-                    { 0,         0,          0 },
-                    { mip_width, mip_height, 1 },
-                },
-                .dstSubresource =
-                {
-                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .mipLevel       = i,
-                    .baseArrayLayer = 0,
-                    .layerCount     = 1,
-                },
-                .dstOffsets =
-                {
-                    { 0,              0,               0 },
-                    { half_mip_width, half_mip_height, 1 },
-                },
-            };
-            vkCmdBlitImage(temp_command_buffer,
-                           image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1, &image_blit,
-                           VK_FILTER_LINEAR);
+                { 0,              0,               0 },
+                { half_mip_width, half_mip_height, 1 },
+            },
+        };
+        vkCmdBlitImage(graphics_command_buffer,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                       image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       1, &image_blit,
+                       VK_FILTER_LINEAR);
 
-            mip_width  = half_mip_width;
-            mip_height = half_mip_height;
-        }
+        mip_width  = half_mip_width;
+        mip_height = half_mip_height;
+    }
 
-        // Transition mip levels 0 -> level_count - 1 to shader_read & shader_read_only_optimal.
-        if (image_info->mip_levels > 1)
+    // Transition mip levels 0 -> level_count - 1 to shader_read & shader_read_only_optimal.
+    if (image_info->mip_levels > 1)
+    {
+        VkImageMemoryBarrier transition_shader_read_only_optimal =
         {
-            VkImageMemoryBarrier transition_shader_read_only_optimal =
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_READ_BIT,
+            .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
+            .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = image,
+            .subresourceRange =
             {
-                .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                .srcAccessMask       = VK_ACCESS_TRANSFER_READ_BIT,
-                .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
-                .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                .newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image               = image,
-                .subresourceRange =
-                {
-                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .baseMipLevel   = 0,
-                    .levelCount     = image_info->mip_levels - 1,
-                    .baseArrayLayer = 0,
-                    .layerCount     = 1,
-                },
-            };
-            vkCmdPipelineBarrier(temp_command_buffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,           // Source Stage Mask
-                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,    // Destination Stage Mask
-                                 0,                                        // Dependency Flags
-                                 0, NULL,                                  // Memory Barriers
-                                 0, NULL,                                  // Buffer Memory Barriers
-                                 1, &transition_shader_read_only_optimal); // Image Memory Barriers
-        }
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel   = 0,
+                .levelCount     = image_info->mip_levels - 1,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+        };
+        vkCmdPipelineBarrier(graphics_command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,           // Source Stage Mask
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,    // Destination Stage Mask
+                             0,                                        // Dependency Flags
+                             0, NULL,                                  // Memory Barriers
+                             0, NULL,                                  // Buffer Memory Barriers
+                             1, &transition_shader_read_only_optimal); // Image Memory Barriers
+    }
 
-        // Transition last mip level to shader_read & shader_read_only_optimal.
+    // Transition last mip level to shader_read & shader_read_only_optimal.
+    {
+        VkImageMemoryBarrier transition_shader_read_only_optimal =
         {
-            VkImageMemoryBarrier transition_shader_read_only_optimal =
+            .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
+            .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image               = image,
+            .subresourceRange =
             {
-                .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
-                .dstAccessMask       = VK_ACCESS_SHADER_READ_BIT,
-                .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                .image               = image,
-                .subresourceRange =
-                {
-                    .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .baseMipLevel   = image_info->mip_levels - 1,
-                    .levelCount     = 1,
-                    .baseArrayLayer = 0,
-                    .layerCount     = 1,
-                },
-            };
-            vkCmdPipelineBarrier(temp_command_buffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,           // Source Stage Mask
-                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,    // Destination Stage Mask
-                                 0,                                        // Dependency Flags
-                                 0, NULL,                                  // Memory Barriers
-                                 0, NULL,                                  // Buffer Memory Barriers
-                                 1, &transition_shader_read_only_optimal); // Image Memory Barriers
-        }
-    SubmitTempCommandBuffer();
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel   = image_info->mip_levels - 1,
+                .levelCount     = 1,
+                .baseArrayLayer = 0,
+                .layerCount     = 1,
+            },
+        };
+        vkCmdPipelineBarrier(graphics_command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,           // Source Stage Mask
+                             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,    // Destination Stage Mask
+                             0,                                        // Dependency Flags
+                             0, NULL,                                  // Memory Barriers
+                             0, NULL,                                  // Buffer Memory Barriers
+                             1, &transition_shader_read_only_optimal); // Image Memory Barriers
+    }
+
+    upload->graphics_commands_recorded = true;
+}
+
+static void LoadImage(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 frame_index,
+                      VkDeviceSize size, uint8* data, VkDeviceSize offset)
+{
+    HostBufferWrite image_data_write =
+    {
+        .size       = size,
+        .src_data   = data,
+        .src_offset = offset,
+        .dst_hnd    = staging_buffer_hnd,
+    };
+    WriteHostBuffer(&image_data_write, frame_index);
+
+    // Staging buffer is reused by the next load, so wait for this upload to complete before returning.
+    BeginUpload();
+        UploadImageCmd(image_hnd, staging_buffer_hnd, frame_index);
+    WaitUpload(SubmitUpload());
 }
 
 static void LoadImage(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 frame_index, ImageData* image_data)
@@ -281,10 +327,18 @@ static void LoadImage(ImageHnd image_hnd, BufferHnd staging_buffer_hnd, uint32 f
               (VkDeviceSize)0);
 }
 
+// Stages image data through the staging ring and records its upload into the current upload, so many images can share
+// one submission without waiting on each other. Image data must fit in GetMaxStagingSize().
+static void StageImageUploadCmd(ImageHnd image_hnd, uint32 frame_index, ImageData* image_data)
+{
+    VkDeviceSize ring_offset = StageData(image_data->data, (VkDeviceSize)image_data->size);
+    UploadImageCmd(image_hnd, GetStagingBuffer(), frame_index, ring_offset);
+}
+
 static VkImageView GetImageView(ImageHnd image_hnd, uint32 frame_index)
 {
     ResourceGroup* res_group = GetResourceGroup(image_hnd.group_index);
-    ValidateImage(res_group, image_hnd.index, "can't get image view");
+    ValidateImage(res_group, image_hnd, "can't get image view");
 
     CTK_ASSERT(frame_index < res_group->frame_count)
 
@@ -78,6 +78,9 @@ struct MeshGroup
     BufferHnd   index_buffer;
     uint32      index_buffer_size;
     uint32      index_count;
+
+    // Vertex and index ranges must advance together so meshes' index offsets match their byte offsets.
+    ResourceLock* lock;
 };
 
 struct MeshModuleInfo
@@ -150,6 +153,8 @@ static MeshGroupHnd CreateMeshGroup(Allocator* allocator, BufferHnd parent_buffe
     mesh_group->index_buffer_size  = info->index_buffer_size;
     mesh_group->vertex_buffer      = CreateBuffer(parent_buffer, &vertex_buffer_info);
     mesh_group->index_buffer       = CreateBuffer(parent_buffer, &index_buffer_info);
+    mesh_group->lock               = Allocate<ResourceLock>(allocator, 1);
+    mesh_group->lock->locked.store(false);
 
     return hnd;
 }
@@ -157,6 +162,7 @@ static MeshGroupHnd CreateMeshGroup(Allocator* allocator, BufferHnd parent_buffe
 static MeshHnd CreateMesh(MeshGroupHnd mesh_group_hnd, MeshInfo* info)
 {
     MeshGroup* mesh_group = GetMeshGroup(mesh_group_hnd.index);
+    LockResources(mesh_group->lock);
     if (mesh_group->meshes.count >= mesh_group->meshes.size)
     {
         CTK_FATAL("can't create mesh: already at max of %u", mesh_group->meshes.size);
@@ -179,6 +185,7 @@ static MeshHnd CreateMesh(MeshGroupHnd mesh_group_hnd, MeshInfo* info)
     index_buffer_frame_state->index  = mesh->index_buffer_offset  + (info->index_count  * info->index_size);
     mesh_group->vertex_count += info->vertex_count;
     mesh_group->index_count  += info->index_count;
+    UnlockResources(mesh_group->lock);
 
     return mesh_hnd;
 }
@@ -214,7 +221,9 @@ static void LoadHostMesh(MeshHnd mesh_hnd, MeshData* mesh_data)
     WriteHostBuffer(&index_buffer_write, FRAME_INDEX);
 }
 
-static void LoadDeviceMesh(MeshHnd mesh_hnd, BufferHnd staging_buffer_hnd, MeshData* mesh_data)
+// Appends mesh data to staging buffer and records its upload into the current upload, so many meshes can share one
+// staging buffer and submission. Staging buffer must not be cleared until the upload completes.
+static void LoadDeviceMeshCmd(MeshHnd mesh_hnd, BufferHnd staging_buffer_hnd, MeshData* mesh_data)
 {
     MeshGroup* mesh_group = GetMeshGroup(mesh_hnd.group_index);
 
@@ -225,7 +234,7 @@ static void LoadDeviceMesh(MeshHnd mesh_hnd, BufferHnd staging_buffer_hnd, MeshD
     Mesh* mesh = GetMesh(mesh_group, mesh_hnd.index);
 
     static constexpr uint32 FRAME_INDEX = 0;
-    Clear(staging_buffer_hnd);
+    VkDeviceSize staging_offset = GetBufferFrameState(staging_buffer_hnd, FRAME_INDEX)->index;
 
     HostBufferAppend vertex_staging =
     {
@@ -244,26 +253,64 @@ static void LoadDeviceMesh(MeshHnd mesh_hnd, BufferHnd staging_buffer_hnd, MeshD
     };
     AppendHostBuffer(&index_staging, FRAME_INDEX);
 
-    BeginTempCommandBuffer();
-        DeviceBufferWrite vertex_buffer_write =
-        {
-            .size       = vertex_buffer_size,
-            .src_hnd    = staging_buffer_hnd,
-            .src_offset = 0,
-            .dst_hnd    = mesh_group->vertex_buffer,
-            .dst_offset = mesh->vertex_buffer_offset,
-        };
-        WriteDeviceBufferCmd(&vertex_buffer_write, FRAME_INDEX);
-        DeviceBufferWrite index_buffer_write =
-        {
-            .size       = index_buffer_size,
-            .src_hnd    = staging_buffer_hnd,
-            .src_offset = vertex_buffer_size,
-            .dst_hnd    = mesh_group->index_buffer,
-            .dst_offset = mesh->index_buffer_offset,
-        };
-        WriteDeviceBufferCmd(&index_buffer_write, FRAME_INDEX);
-    SubmitTempCommandBuffer();
+    DeviceBufferWrite vertex_buffer_write =
+    {
+        .size       = vertex_buffer_size,
+        .src_hnd    = staging_buffer_hnd,
+        .src_offset = staging_offset,
+        .dst_hnd    = mesh_group->vertex_buffer,
+        .dst_offset = mesh->vertex_buffer_offset,
+    };
+    UploadBufferCmd(&vertex_buffer_write, FRAME_INDEX);
+    DeviceBufferWrite index_buffer_write =
+    {
+        .size       = index_buffer_size,
+        .src_hnd    = staging_buffer_hnd,
+        .src_offset = staging_offset + vertex_buffer_size,
+        .dst_hnd    = mesh_group->index_buffer,
+        .dst_offset = mesh->index_buffer_offset,
+    };
+    UploadBufferCmd(&index_buffer_write, FRAME_INDEX);
+}
+
+// Streams mesh data through the staging ring into the current upload, so meshes of any size can be uploaded without a
+// dedicated staging buffer.
+static void LoadDeviceMeshCmd(MeshHnd mesh_hnd, MeshData* mesh_data)
+{
+    MeshGroup* mesh_group = GetMeshGroup(mesh_hnd.group_index);
+
+    uint32 vertex_buffer_size = mesh_data->info.vertex_size * mesh_data->info.vertex_count;
+    uint32 index_buffer_size  = mesh_data->info.index_size  * mesh_data->info.index_count;
+    ValidateMeshDataLoad(mesh_group, mesh_hnd.group_index, vertex_buffer_size, index_buffer_size);
+
+    Mesh* mesh = GetMesh(mesh_group, mesh_hnd.index);
+
+    static constexpr uint32 FRAME_INDEX = 0;
+    StagedBufferWrite vertex_buffer_write =
+    {
+        .size       = vertex_buffer_size,
+        .src_data   = mesh_data->vertex_buffer,
+        .dst_hnd    = mesh_group->vertex_buffer,
+        .dst_offset = mesh->vertex_buffer_offset,
+    };
+    StageBufferUploadCmd(&vertex_buffer_write, FRAME_INDEX);
+    StagedBufferWrite index_buffer_write =
+    {
+        .size       = index_buffer_size,
+        .src_data   = mesh_data->index_buffer,
+        .dst_hnd    = mesh_group->index_buffer,
+        .dst_offset = mesh->index_buffer_offset,
+    };
+    StageBufferUploadCmd(&index_buffer_write, FRAME_INDEX);
+}
+
+static void LoadDeviceMesh(MeshHnd mesh_hnd, BufferHnd staging_buffer_hnd, MeshData* mesh_data)
+{
+    // Staging buffer is reused by the next load, so wait for this upload to complete before returning.
+    Clear(staging_buffer_hnd);
+    BeginUpload();
+        LoadDeviceMeshCmd(mesh_hnd, staging_buffer_hnd, mesh_data);
+    WaitUpload(SubmitUpload());
 }
 
 static void LoadMeshData(MeshData* mesh_data, Allocator* allocator, const char* path,
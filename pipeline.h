@@ -103,7 +103,7 @@ static void CreatePipeline(Pipeline* pipeline)
 
     VkPipelineInputAssemblyStateCreateInfo input_assembly_state = DEFAULT_INPUT_ASSEMBLY_STATE;
 
-    // Viewport/Scissors
+    // Viewport/Scissors (viewports and scissors are dynamic state set in BindPipeline(), only their counts are baked)
     VkPipelineViewportStateCreateInfo viewport_state = DEFAULT_VIEWPORT_STATE;
     viewport_state.viewportCount = pipeline->viewports.count;
     viewport_state.pViewports    = pipeline->viewports.data;
@@ -126,7 +126,15 @@ static void CreatePipeline(Pipeline* pipeline)
     static constexpr VkPipelineColorBlendStateCreateInfo COLOR_BLEND_STATE =
         DefaultColorBlendStateCreateInfo(&DEFAULT_COLOR_BLEND_ATTACHMENT_STATE, 1);
 
+    // Dynamic State
+    static constexpr VkDynamicState DYNAMIC_STATES[] =
+    {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
     VkPipelineDynamicStateCreateInfo dynamic_state = DEFAULT_DYNAMIC_STATE;
+    dynamic_state.dynamicStateCount = CTK_ARRAY_SIZE(DYNAMIC_STATES);
+    dynamic_state.pDynamicStates    = DYNAMIC_STATES;
 
     // Pipeline
     VkGraphicsPipelineCreateInfo create_info =
@@ -151,7 +159,7 @@ static void CreatePipeline(Pipeline* pipeline)
         .basePipelineHandle  = VK_NULL_HANDLE,
         .basePipelineIndex   = -1,
     };
-    VkResult res = vkCreateGraphicsPipelines(GetDevice(), VK_NULL_HANDLE, 1, &create_info, NULL, &pipeline->hnd);
+    VkResult res = vkCreateGraphicsPipelines(GetDevice(), GetPipelineCache(), 1, &create_info, NULL, &pipeline->hnd);
     Validate(res, "vkCreateGraphicsPipelines() failed");
 }
 
@@ -276,6 +284,8 @@ static Pipeline* CreatePipeline(Allocator* allocator, FreeList* free_list, Pipel
 
 static void UpdatePipelineViewports(Pipeline* pipeline, Array<VkViewport> viewports)
 {
+    uint32 prev_viewport_count = pipeline->viewports.count;
+
     // Update viewports and scissors arrays.
     Clear(&pipeline->viewports);
     Clear(&pipeline->scissors);
@@ -287,7 +297,10 @@ static void UpdatePipelineViewports(Pipeline* pipeline, Array<VkViewport> viewpo
     PushRange(&pipeline->viewports, &viewports);
     InitScissors(pipeline);
 
-    // Recreate pipeline.
-    vkDestroyPipeline(GetDevice(), pipeline->hnd, NULL);
-    CreatePipeline(pipeline);
+    // Viewports and scissors are dynamic state, so pipeline only needs to be recreated if their count changed.
+    if (pipeline->viewports.count != prev_viewport_count)
+    {
+        vkDestroyPipeline(GetDevice(), pipeline->hnd, NULL);
+        CreatePipeline(pipeline);
+    }
 }
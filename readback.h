@@ -0,0 +1,475 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr VkDeviceSize READBACK_ALIGNMENT      = 16; // Satisfies buffer-image copy offset requirements.
+static constexpr uint32 DEFAULT_MAX_PENDING_READBACKS = 64;
+
+struct ReadbackRingInfo
+{
+    BufferHnd buffer;        // Host visible buffer copies are written to, preferably HOST_CACHED; its size is the ring.
+    uint32    max_readbacks; // Max readbacks not yet released. Uses DEFAULT_MAX_PENDING_READBACKS if 0.
+};
+
+struct BufferReadback
+{
+    VkDeviceSize size;
+    BufferHnd    src_hnd;
+    VkDeviceSize src_offset;
+};
+
+// Readback is complete once frame timeline reaches frame_value. frame_value is 0 if readback couldn't be recorded
+// because the ring was full.
+struct ReadbackTicket
+{
+    uint64       frame_value;
+    uint32       region_index;
+    VkDeviceSize offset; // Ring offset data is copied to.
+    VkDeviceSize size;
+};
+
+struct ReadbackRegion
+{
+    VkDeviceSize end;
+    bool         released;
+};
+
+// Head and tail are offsets into an unbounded stream of read back bytes, as with the staging ring.
+struct ReadbackRing
+{
+    bool                   enabled;
+    BufferHnd              buffer;
+    VkDeviceSize           size;
+    VkDeviceSize           head;
+    VkDeviceSize           tail;
+
+    // FIFO of regions not yet released, oldest first. Tail advances past released regions at the front.
+    ReadbackRegion*        regions; // size: max_regions
+    uint32                 max_regions;
+    uint32                 first_region;
+    uint32                 region_count;
+
+    VkCommandPool          command_pool;
+    Array<VkCommandBuffer> command_buffers; // One per frame; submitted after frame's render commands.
+    bool                   recording;       // Current frame's command buffer has copies recorded.
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static ReadbackRing g_readback;
+
+/// Utils
+////////////////////////////////////////////////////////////
+static ReadbackRegion* GetReadbackRegion(uint32 region_index)
+{
+    return &g_readback.regions[region_index % g_readback.max_regions];
+}
+
+static void ReclaimReleasedReadbackRegions()
+{
+    while (g_readback.region_count > 0 && GetReadbackRegion(g_readback.first_region)->released)
+    {
+        g_readback.tail = GetReadbackRegion(g_readback.first_region)->end;
+        g_readback.first_region = (g_readback.first_region + 1) % g_readback.max_regions;
+        g_readback.region_count -= 1;
+    }
+}
+
+// Claims size contiguous bytes of the ring, wrapping to its start if the end doesn't have room. Never blocks; returns
+// false if the ring or region FIFO is full.
+static bool ClaimReadback(VkDeviceSize size, VkDeviceSize* ring_offset, uint32* region_index)
+{
+    ReclaimReleasedReadbackRegions();
+    if (g_readback.region_count == g_readback.max_regions)
+    {
+        return false;
+    }
+
+    VkDeviceSize start     = Align(g_readback.head, READBACK_ALIGNMENT);
+    VkDeviceSize used_size = start - g_readback.tail;
+    VkDeviceSize free_size = used_size < g_readback.size ? g_readback.size - used_size : 0;
+    VkDeviceSize offset    = start % g_readback.size;
+    VkDeviceSize end_size  = g_readback.size - offset; // Bytes between head and the end of the ring.
+    if (size > end_size)
+    {
+        // Skipped bytes belong to the claimed region, so they're freed along with it.
+        start += end_size;
+        offset = 0;
+        free_size = free_size > end_size ? free_size - end_size : 0;
+    }
+    if (size > free_size)
+    {
+        return false;
+    }
+
+    g_readback.head = start + size;
+    *ring_offset = offset;
+    *region_index = (g_readback.first_region + g_readback.region_count) % g_readback.max_regions;
+    *GetReadbackRegion(*region_index) =
+    {
+        .end      = g_readback.head,
+        .released = false,
+    };
+    g_readback.region_count += 1;
+    return true;
+}
+
+static VkCommandBuffer GetReadbackCommandBuffer()
+{
+    VkCommandBuffer command_buffer = Get(&g_readback.command_buffers, GetFrameIndex());
+    if (g_readback.recording)
+    {
+        return command_buffer;
+    }
+
+    BeginUploadCommandBuffer(command_buffer);
+    g_readback.recording = true;
+
+    // Copies must wait for the frame's render commands to finish writing the resources being read.
+    VkMemoryBarrier barrier =
+    {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext         = NULL,
+        .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+    };
+    vkCmdPipelineBarrier(command_buffer,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // Source Stage Mask
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,     // Destination Stage Mask
+                         0,                                  // Dependency Flags
+                         1, &barrier,                        // Memory Barriers
+                         0, NULL,                            // Buffer Memory Barriers
+                         0, NULL);                           // Image Memory Barriers
+
+    return command_buffer;
+}
+
+static ReadbackTicket ClaimReadbackTicket(VkDeviceSize size)
+{
+    if (size > g_readback.size)
+    {
+        CTK_FATAL("can't read back %u bytes: exceeds readback ring size of %u bytes", size, g_readback.size);
+    }
+
+    ReadbackTicket ticket = {};
+    if (!ClaimReadback(size, &ticket.offset, &ticket.region_index))
+    {
+        return ticket;
+    }
+    ticket.frame_value = GetSubmittedFrameValue() + 1; // Copies complete along with the current frame.
+    ticket.size        = size;
+    return ticket;
+}
+
+static VkDeviceSize GetReadbackBufferOffset(ReadbackTicket ticket)
+{
+    return GetBufferFrameState(g_readback.buffer, 0)->res_mem_offset + ticket.offset;
+}
+
+// Only uncompressed formats images are commonly read back in are supported.
+static VkDeviceSize GetTexelSize(VkFormat format)
+{
+    switch (format)
+    {
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_UINT:
+            return 1;
+        case VK_FORMAT_R8G8_UNORM:
+        case VK_FORMAT_R16_SFLOAT:
+        case VK_FORMAT_R16_UINT:
+            return 2;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_R16G16_SFLOAT:
+        case VK_FORMAT_R32_SFLOAT:
+        case VK_FORMAT_R32_UINT:
+        case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+            return 4;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        case VK_FORMAT_R32G32_SFLOAT:
+            return 8;
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+            return 16;
+        default:
+            CTK_FATAL("can't get texel size of format %u: format not supported for readback", format);
+    }
+}
+
+static void TransitionReadbackImage(VkCommandBuffer command_buffer, VkImage image, VkImageLayout old_layout,
+                                    VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access,
+                                    VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage)
+{
+    VkImageMemoryBarrier barrier =
+    {
+        .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext               = NULL,
+        .srcAccessMask       = src_access,
+        .dstAccessMask       = dst_access,
+        .oldLayout           = old_layout,
+        .newLayout           = new_layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image               = image,
+        .subresourceRange    =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = 1,
+            .baseArrayLayer = 0,
+            .layerCount     = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+    vkCmdPipelineBarrier(command_buffer,
+                         src_stage,    // Source Stage Mask
+                         dst_stage,    // Destination Stage Mask
+                         0,            // Dependency Flags
+                         0, NULL,      // Memory Barriers
+                         0, NULL,      // Buffer Memory Barriers
+                         1, &barrier); // Image Memory Barriers
+}
+
+// Copies mip level 0 of all of image's layers, tightly packed, into the ring. Image is returned to layout once copied.
+// The command buffer's initial barrier already waits on all of the frame's writes, so images already in the
+// TRANSFER_SRC_OPTIMAL layout (e.g. headless swapchain images) need no transitions.
+static ReadbackTicket RecordImageReadback(VkImage image, VkImageLayout layout, VkAccessFlags access,
+                                          VkPipelineStageFlags stage, VkExtent3D extent, uint32 layer_count,
+                                          VkFormat format)
+{
+    VkDeviceSize size = GetTexelSize(format) * extent.width * extent.height * extent.depth * layer_count;
+    ReadbackTicket ticket = ClaimReadbackTicket(size);
+    if (ticket.frame_value == 0)
+    {
+        return ticket;
+    }
+
+    VkCommandBuffer command_buffer = GetReadbackCommandBuffer();
+    if (layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+    {
+        TransitionReadbackImage(command_buffer, image, layout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                access, VK_ACCESS_TRANSFER_READ_BIT, stage, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    }
+    VkBufferImageCopy copy =
+    {
+        .bufferOffset      = GetReadbackBufferOffset(ticket),
+        .bufferRowLength   = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource  =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel       = 0,
+            .baseArrayLayer = 0,
+            .layerCount     = layer_count,
+        },
+        .imageOffset       = { 0, 0, 0 },
+        .imageExtent       = extent,
+    };
+    vkCmdCopyImageToBuffer(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           GetBuffer(g_readback.buffer), 1, &copy);
+    if (layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+    {
+        TransitionReadbackImage(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, layout,
+                                VK_ACCESS_NONE, access,
+                                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+
+    return ticket;
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitReadbackRing(Allocator* allocator, ReadbackRingInfo* info)
+{
+    ResourceGroup* res_group = GetResourceGroup(info->buffer.group_index);
+    ValidateBuffer(res_group, info->buffer, "can't init readback ring");
+    BufferState* buffer_state = GetBufferState(res_group, info->buffer.index);
+    if (buffer_state->frame_count != 1)
+    {
+        CTK_FATAL("can't init readback ring: buffer must not be per-frame");
+    }
+    ResourceMemory* res_mem = GetResourceMemory(res_group, buffer_state->res_mem_index);
+    if ((res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0)
+    {
+        CTK_FATAL("can't init readback ring: buffer must be host visible");
+    }
+    if ((res_mem->buffer_usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) == 0)
+    {
+        CTK_FATAL("can't init readback ring: buffer usage must include VK_BUFFER_USAGE_TRANSFER_DST_BIT");
+    }
+
+    // Ring offsets are kept aligned by keeping ring size a multiple of the alignment.
+    VkDeviceSize size = GetBufferInfo(res_group, info->buffer.index)->size / READBACK_ALIGNMENT * READBACK_ALIGNMENT;
+    if (size == 0)
+    {
+        CTK_FATAL("can't init readback ring: buffer size is less than alignment of %u", READBACK_ALIGNMENT);
+    }
+
+    VkDevice device = GetDevice();
+    uint32 frame_count = GetFrameCount();
+    g_readback.enabled         = true;
+    g_readback.buffer          = info->buffer;
+    g_readback.size            = size;
+    g_readback.head            = 0;
+    g_readback.tail            = 0;
+    g_readback.max_regions     = info->max_readbacks > 0 ? info->max_readbacks : DEFAULT_MAX_PENDING_READBACKS;
+    g_readback.regions         = Allocate<ReadbackRegion>(allocator, g_readback.max_regions);
+    g_readback.first_region    = 0;
+    g_readback.region_count    = 0;
+    g_readback.command_pool    = CreateUploadCommandPool(device, GetPhysicalDevice()->queue_families.graphics);
+    g_readback.command_buffers = CreateArray<VkCommandBuffer>(allocator, frame_count);
+    for (uint32 frame_index = 0; frame_index < frame_count; ++frame_index)
+    {
+        Push(&g_readback.command_buffers, AllocateUploadCommandBuffer(device, g_readback.command_pool));
+    }
+    g_readback.recording       = false;
+}
+
+// Records a copy of buffer's frame range into the readback ring, executed after the current frame's render commands.
+// Must be called on the main thread between AcquireSwapchainImage() and SubmitRenderCommands(). Never blocks: if the
+// ring is full, returned ticket's frame_value is 0 and the readback should be retried on a later frame.
+static ReadbackTicket ReadbackBuffer(BufferReadback* readback, uint32 frame_index)
+{
+    CTK_ASSERT(g_readback.enabled);
+    ResourceGroup* res_group = GetResourceGroup(readback->src_hnd.group_index);
+    ValidateBuffer(res_group, readback->src_hnd, "can't read back buffer");
+    CTK_ASSERT(frame_index < res_group->frame_count);
+    CTK_ASSERT(readback->src_offset + readback->size <= GetBufferState(res_group, readback->src_hnd.index)->size);
+
+    ReadbackTicket ticket = ClaimReadbackTicket(readback->size);
+    if (ticket.frame_value == 0)
+    {
+        return ticket;
+    }
+
+    VkBufferCopy region =
+    {
+        .srcOffset = GetBufferFrameState(res_group, readback->src_hnd.index, frame_index)->res_mem_offset +
+                     readback->src_offset,
+        .dstOffset = GetReadbackBufferOffset(ticket),
+        .size      = readback->size,
+    };
+    vkCmdCopyBuffer(GetReadbackCommandBuffer(), GetBuffer(res_group, readback->src_hnd.index),
+                    GetBuffer(g_readback.buffer), 1, &region);
+
+    return ticket;
+}
+
+// Records a copy of mip level 0 of image's frame image into the readback ring. Image layouts aren't tracked, so image
+// is assumed to be a color image in the SHADER_READ_ONLY_OPTIMAL layout descriptor sets bind it with, and must have
+// been created with TRANSFER_SRC usage. Same calling rules as ReadbackBuffer().
+static ReadbackTicket ReadbackImage(ImageHnd image_hnd, uint32 frame_index)
+{
+    CTK_ASSERT(g_readback.enabled);
+    ResourceGroup* res_group = GetResourceGroup(image_hnd.group_index);
+    ValidateImage(res_group, image_hnd, "can't read back image");
+    CTK_ASSERT(frame_index < res_group->frame_count);
+
+    ImageMemoryInfo* image_mem_info =
+        GetImageMemoryInfo(res_group, GetImageState(res_group, image_hnd.index)->image_mem_index);
+    if ((image_mem_info->usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) == 0)
+    {
+        CTK_FATAL("can't read back image: image's memory usage doesn't include VK_IMAGE_USAGE_TRANSFER_SRC_BIT");
+    }
+
+    ImageInfo* image_info = GetImageInfo(res_group, image_hnd.index);
+    return RecordImageReadback(GetImageFrameState(res_group, image_hnd.index, frame_index)->image,
+                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT,
+                               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, image_info->extent, image_info->array_layers,
+                               image_mem_info->format);
+}
+
+// Records a copy of the current frame's swapchain image, as rendered by this frame, into the readback ring, e.g. for
+// screenshots or headless output. Same calling rules as ReadbackBuffer().
+static ReadbackTicket ReadbackSwapchainImage()
+{
+    CTK_ASSERT(g_readback.enabled);
+    Swapchain* swapchain = GetSwapchain();
+    if ((swapchain->image_usage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT) == 0)
+    {
+        CTK_FATAL("can't read back swapchain image: surface doesn't support VK_IMAGE_USAGE_TRANSFER_SRC_BIT");
+    }
+    VkImageLayout layout = IsHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VkExtent3D extent =
+    {
+        .width  = swapchain->surface_extent.width,
+        .height = swapchain->surface_extent.height,
+        .depth  = 1,
+    };
+    return RecordImageReadback(Get(&swapchain->images, GetCurrentFrame()->swapchain_image_index), layout,
+                               VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                               extent, 1, swapchain->surface_format.format);
+}
+
+static bool ReadbackComplete(ReadbackTicket ticket)
+{
+    CTK_ASSERT(ticket.frame_value != 0);
+    return GetCompletedFrameValue() >= ticket.frame_value;
+}
+
+// Blocks until readback completes; prefer polling ReadbackComplete() once per frame so the render loop never stalls.
+static void WaitReadback(ReadbackTicket ticket)
+{
+    CTK_ASSERT(ticket.frame_value != 0);
+    WaitFrameValue(ticket.frame_value);
+}
+
+// Returns pointer to completed readback's data, invalidating it first if the ring's memory is non-coherent. Data stays
+// valid until ReleaseReadback() is called.
+static uint8* GetReadbackData(ReadbackTicket ticket)
+{
+    if (!ReadbackComplete(ticket))
+    {
+        CTK_FATAL("can't get readback data: readback for frame %u hasn't completed", ticket.frame_value);
+    }
+
+    ResourceGroup* res_group = GetResourceGroup(g_readback.buffer.group_index);
+    VkDeviceSize offset = GetReadbackBufferOffset(ticket);
+    if (IsHostNonCoherent(res_group, g_readback.buffer.index))
+    {
+        VkMappedMemoryRange range = GetBufferMappedRange(res_group, g_readback.buffer.index, offset, ticket.size);
+        VkResult res = vkInvalidateMappedMemoryRanges(GetDevice(), 1, &range);
+        Validate(res, "vkInvalidateMappedMemoryRanges() failed");
+    }
+
+    return &GetBufferMappedMemory(res_group, g_readback.buffer.index)[offset];
+}
+
+// Frees readback's range of the ring. Readbacks may be released in any order, but ring space is only reused once all
+// older readbacks have been released too.
+static void ReleaseReadback(ReadbackTicket ticket)
+{
+    CTK_ASSERT(ReadbackComplete(ticket));
+    ReadbackRegion* region = GetReadbackRegion(ticket.region_index);
+    CTK_ASSERT(!region->released);
+    region->released = true;
+}
+
+// Ends current frame's readback commands, returning true if any were recorded. Called by SubmitRenderCommands().
+static bool EndReadbackCommands(VkCommandBuffer* command_buffer)
+{
+    if (!g_readback.recording)
+    {
+        return false;
+    }
+
+    // Make copies visible to the host once the frame's timeline value is signaled.
+    *command_buffer = Get(&g_readback.command_buffers, GetFrameIndex());
+    VkMemoryBarrier barrier =
+    {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext         = NULL,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+    };
+    vkCmdPipelineBarrier(*command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, // Source Stage Mask
+                         VK_PIPELINE_STAGE_HOST_BIT,     // Destination Stage Mask
+                         0,                              // Dependency Flags
+                         1, &barrier,                    // Memory Barriers
+                         0, NULL,                        // Buffer Memory Barriers
+                         0, NULL);                       // Image Memory Barriers
+    VkResult res = vkEndCommandBuffer(*command_buffer);
+    Validate(res, "vkEndCommandBuffer() failed");
+    g_readback.recording = false;
+
+    return true;
+}
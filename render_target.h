@@ -20,13 +20,13 @@ struct RenderTarget
     uint32 total_attachment_count;
 
     // State
-    VkRenderPass         render_pass;
-    VkExtent2D           extent;
-    Array<VkFramebuffer> framebuffers;
-    Array<VkClearValue>  attachment_clear_values;
-    ResourceGroupHnd     depth_image_group;
-    ImageMemoryHnd       depth_image_mem;
-    ImageHnd             depth_image;
+    VkRenderPass        render_pass;
+    VkExtent2D          extent;
+    VkFramebuffer       framebuffer; // Imageless: attachment views are provided when the render pass begins.
+    Array<VkClearValue> attachment_clear_values;
+    ResourceGroupHnd    depth_image_group;
+    ImageMemoryHnd      depth_image_mem;
+    ImageHnd            depth_image;
 };
 
 /// Utils
@@ -53,13 +53,12 @@ static void SetDepthAttachment(RenderPassAttachments* attachments, VkAttachmentD
     });
 }
 
-static void SetupRenderTarget(RenderTarget* render_target, FreeList* free_list)
-{
-    CTK::Frame frame = CreateFrame();
+static constexpr VkImageUsageFlags DEPTH_IMAGE_USAGE = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
 
+static void SetupRenderTarget(RenderTarget* render_target)
+{
     Swapchain* swapchain = GetSwapchain();
-    VkDevice device = GetDevice();
-    VkResult res = VK_SUCCESS;
+    PhysicalDevice* physical_device = GetPhysicalDevice();
 
     // Set render target to cover entire swapchain extent.
     render_target->extent = swapchain->surface_extent;
@@ -86,12 +85,17 @@ static void SetupRenderTarget(RenderTarget* render_target, FreeList* free_list)
         {
             .size       = 0,
             .flags      = 0,
-            .usage      = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            .usage      = DEPTH_IMAGE_USAGE,
             .properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            .format     = GetPhysicalDevice()->depth_image_format,
+            .format     = physical_device->depth_image_format,
             .tiling     = VK_IMAGE_TILING_OPTIMAL,
         };
-        depth_image_mem_info.size = GetImageSize(&depth_image_info, &depth_image_mem_info);
+        // Depth image only needs image memory if driver doesn't prefer giving it a dedicated allocation.
+        VkMemoryRequirements depth_mem_requirements = {};
+        if (!GetImageMemoryRequirements(&depth_mem_requirements, &depth_image_info, &depth_image_mem_info))
+        {
+            depth_image_mem_info.size = depth_mem_requirements.size;
+        }
         render_target->depth_image_mem = DefineImageMemory(render_target->depth_image_group, &depth_image_mem_info);
 
         AllocateResourceGroup(render_target->depth_image_group);
@@ -114,34 +118,59 @@ static void SetupRenderTarget(RenderTarget* render_target, FreeList* free_list)
             CreateImage(render_target->depth_image_mem, &depth_image_info, &depth_image_view_info);
     }
 
-    // Init framebuffers.
-    render_target->framebuffers = CreateArray<VkFramebuffer>(free_list, swapchain->image_views.count);
-    auto attachments = CreateArray<VkImageView>(&frame, render_target->total_attachment_count);
-    for (uint32 i = 0; i < swapchain->image_views.count; ++i)
+    // Init imageless framebuffer. Only attachment image properties are baked in, so swapchain recreation only
+    // requires a new framebuffer when the extent changes.
+    FArray<VkFramebufferAttachmentImageInfo, 2> attachment_image_infos = {};
+    Push(&attachment_image_infos,
     {
-        Push(&attachments, Get(&swapchain->image_views, i));
-
-        if (render_target->depth_testing)
-        {
-            Push(&attachments, GetImageView(render_target->depth_image, 0));
-        }
-
-        VkFramebufferCreateInfo info =
+        .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO,
+        .pNext           = NULL,
+        .flags           = 0,
+        .usage           = swapchain->image_usage,
+        .width           = render_target->extent.width,
+        .height          = render_target->extent.height,
+        .layerCount      = 1,
+        .viewFormatCount = 1,
+        .pViewFormats    = &swapchain->surface_format.format,
+    });
+    if (render_target->depth_testing)
+    {
+        Push(&attachment_image_infos,
         {
-            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass      = render_target->render_pass,
-            .attachmentCount = attachments.count,
-            .pAttachments    = attachments.data,
+            .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO,
+            .pNext           = NULL,
+            .flags           = 0,
+            .usage           = DEPTH_IMAGE_USAGE,
             .width           = render_target->extent.width,
             .height          = render_target->extent.height,
-            .layers          = 1,
-        };
-        res = vkCreateFramebuffer(GetDevice(), &info, NULL, Push(&render_target->framebuffers));
-        Validate(res, "vkCreateFramebuffer() failed");
-
-        // Clear attachments for next iteration.
-        Clear(&attachments);
+            .layerCount      = 1,
+            .viewFormatCount = 1,
+            .pViewFormats    = &physical_device->depth_image_format,
+        });
     }
+    CTK_ASSERT(attachment_image_infos.count == render_target->total_attachment_count);
+
+    VkFramebufferAttachmentsCreateInfo attachments_info =
+    {
+        .sType                    = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO,
+        .pNext                    = NULL,
+        .attachmentImageInfoCount = attachment_image_infos.count,
+        .pAttachmentImageInfos    = attachment_image_infos.data,
+    };
+    VkFramebufferCreateInfo info =
+    {
+        .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+        .pNext           = &attachments_info,
+        .flags           = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT,
+        .renderPass      = render_target->render_pass,
+        .attachmentCount = attachment_image_infos.count,
+        .pAttachments    = NULL,
+        .width           = render_target->extent.width,
+        .height          = render_target->extent.height,
+        .layers          = 1,
+    };
+    VkResult res = vkCreateFramebuffer(GetDevice(), &info, NULL, &render_target->framebuffer);
+    Validate(res, "vkCreateFramebuffer() failed");
 }
 
 /// Interface
@@ -183,7 +212,8 @@ static void InitRenderTarget(RenderTarget* render_target, Stack* perm_stack, Fre
                             .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
                             .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
                             .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
-                            .finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                            .finalLayout    = IsHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                                           : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
                         });
 
     if (render_target->depth_testing)
@@ -227,25 +257,26 @@ static void InitRenderTarget(RenderTarget* render_target, Stack* perm_stack, Fre
     // Copy attachment clear values.
     render_target->attachment_clear_values = CreateArray<VkClearValue>(perm_stack, &info->attachment_clear_values);
 
-    // Create depth images and framebuffers based on swapchain extent.
-    SetupRenderTarget(render_target, free_list);
+    // Create depth images and framebuffer based on swapchain extent.
+    SetupRenderTarget(render_target);
 }
 
-static void UpdateRenderTargetAttachments(RenderTarget* render_target, FreeList* free_list)
+static void UpdateRenderTargetAttachments(RenderTarget* render_target)
 {
-    // Destroy depth images.
-    if (render_target->depth_testing)
+    // Framebuffer is imageless, so attachments only need to be recreated if swapchain extent changed.
+    VkExtent2D new_extent = GetSwapchain()->surface_extent;
+    if (new_extent.width == render_target->extent.width && new_extent.height == render_target->extent.height)
     {
-        DeallocateResourceGroup(render_target->depth_image_group);
+        return;
     }
 
-    // Destroy framebuffers.
-    for (uint32 i = 0; i < render_target->framebuffers.count; ++i)
+    // Retire depth images and framebuffer; in-flight frames may still be using them.
+    if (render_target->depth_testing)
     {
-        vkDestroyFramebuffer(GetDevice(), Get(&render_target->framebuffers, i), NULL);
+        RetireResourceGroup(render_target->depth_image_group);
     }
-    DestroyArray(&render_target->framebuffers);
+    Retire(RetiredType::FRAMEBUFFER, (uint64)render_target->framebuffer);
 
-    // Re-create depth images and framebuffers with new swapchain extent.
-    SetupRenderTarget(render_target, free_list);
+    // Re-create depth images and framebuffer with new swapchain extent.
+    SetupRenderTarget(render_target);
 }
@@ -2,13 +2,36 @@
 ////////////////////////////////////////////////////////////
 static VkResult AcquireSwapchainImage()
 {
+    RTK_TRACE_SCOPE("AcquireSwapchainImage");
+
     VkDevice device = GetDevice();
     Frame* frame = GetCurrentFrame();
     VkResult res = VK_SUCCESS;
 
-    // Wait for frame's command buffers to be done executing.
-    res = vkWaitForFences(device, 1, &frame->command_buffers_complete, VK_TRUE, UINT64_MAX);
-    Validate(res, "vkWaitForFences() failed");
+    // Wait for frame's command buffers to be done executing, then destroy any retired handles no longer in use.
+    {
+        RTK_TRACE_SCOPE("WaitFrame");
+        WaitFrameValue(frame->timeline_value);
+    }
+    DestroyCompletedRetired();
+    ReclaimDestroyedResources();
+    ReleaseDefragMoves();
+    ResetTransientAllocator();
+    ReadGPUProfilerResults();
+
+    // Headless contexts have no presentation engine; cycle through offscreen images in order. Image cycle is
+    // independent of frame slots (frame count can exceed image count), so wait for image's last submission too.
+    if (IsHeadless())
+    {
+        Swapchain* swapchain = GetSwapchain();
+        frame->swapchain_image_index = swapchain->next_image_index;
+        swapchain->next_image_index = (swapchain->next_image_index + 1) % swapchain->images.count;
+        {
+            RTK_TRACE_SCOPE("WaitImage");
+            WaitFrameValue(Get(&swapchain->image_frame_values, frame->swapchain_image_index));
+        }
+        return res;
+    }
 
     // Once frame is ready, acquire next swapchain image's index.
     res = vkAcquireNextImageKHR(device, GetSwapchain()->hnd, UINT64_MAX, frame->image_acquired, VK_NULL_HANDLE,
@@ -21,20 +44,13 @@ static VkResult AcquireSwapchainImage()
     // Swapchain image aqcuisition succeeded and frame->image_acquired will be signaled.
     if (res == VK_SUBOPTIMAL_KHR)
     {
-        // If swapchain image is suboptimal, continue normally and recreate swapchain when device is idle.
+        // If swapchain image is suboptimal, continue normally and recreate swapchain after submission.
     }
     else
     {
         Validate(res, "vkAcquireNextImageKHR() failed");
     }
 
-    // Only reset fence after successful image acquisition (vkAcquireNextImageKHR() did not return
-    // VK_ERROR_OUT_OF_DATE_KHR). vkResetFences() will unsignal frame->command_buffers_complete and cause the next
-    // call to vkWaitForFences() to deadlock as the command buffers were not subbmitted again due to swapchain needing
-    // to be recreated.
-    res = vkResetFences(device, 1, &frame->command_buffers_complete);
-    Validate(res, "vkResetFences() failed");
-
     return res;
 }
 
@@ -49,7 +65,7 @@ static VkCommandBuffer BeginRenderCommands(RenderTarget* render_target, uint32 r
         .pNext                = NULL,
         .renderPass           = render_target->render_pass,
         .subpass              = 0,
-        .framebuffer          = Get(&render_target->framebuffers, frame->swapchain_image_index),
+        .framebuffer          = render_target->framebuffer,
         .occlusionQueryEnable = VK_FALSE,
         .queryFlags           = 0,
         .pipelineStatistics   = 0,
@@ -69,6 +85,10 @@ static VkCommandBuffer BeginRenderCommands(RenderTarget* render_target, uint32 r
 static void BindPipeline(VkCommandBuffer command_buffer, Pipeline* pipeline)
 {
     vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->hnd);
+
+    // Secondary command buffers don't inherit dynamic state, so viewports and scissors are set with every bind.
+    vkCmdSetViewport(command_buffer, 0, pipeline->viewports.count, pipeline->viewports.data);
+    vkCmdSetScissor(command_buffer, 0, pipeline->scissors.count, pipeline->scissors.data);
 }
 
 static void BindDescriptorSets(VkCommandBuffer command_buffer, Pipeline* pipeline,
@@ -126,6 +146,8 @@ static void EndRenderCommands(VkCommandBuffer command_buffer)
 
 static VkResult SubmitRenderCommands(RenderTarget* render_target)
 {
+    RTK_TRACE_SCOPE("SubmitRenderCommands");
+
     Frame* frame = GetCurrentFrame();
     VkResult res = VK_SUCCESS;
 
@@ -142,13 +164,26 @@ static VkResult SubmitRenderCommands(RenderTarget* render_target)
     res = vkBeginCommandBuffer(command_buffer, &command_buffer_begin_info);
     Validate(res, "vkBeginCommandBuffer() failed");
 
-    // Begin render pass.
+    // Begin render pass, providing attachment views for render target's imageless framebuffer.
+    FArray<VkImageView, 2> attachment_views = {};
+    Push(&attachment_views, Get(&GetSwapchain()->image_views, frame->swapchain_image_index));
+    if (render_target->depth_testing)
+    {
+        Push(&attachment_views, GetImageView(render_target->depth_image, 0));
+    }
+    VkRenderPassAttachmentBeginInfo attachment_begin_info =
+    {
+        .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO,
+        .pNext           = NULL,
+        .attachmentCount = attachment_views.count,
+        .pAttachments    = attachment_views.data,
+    };
     VkRenderPassBeginInfo render_pass_begin_info =
     {
         .sType       = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .pNext       = NULL,
+        .pNext       = &attachment_begin_info,
         .renderPass  = render_target->render_pass,
-        .framebuffer = Get(&render_target->framebuffers, frame->swapchain_image_index),
+        .framebuffer = render_target->framebuffer,
         .renderArea  =
         {
             .offset = { 0, 0 },
@@ -157,32 +192,80 @@ static VkResult SubmitRenderCommands(RenderTarget* render_target)
         .clearValueCount = render_target->attachment_clear_values.count,
         .pClearValues    = render_target->attachment_clear_values.data,
     };
+    // Primary command buffer is recorded on main thread, which uses the GPU profiler thread index after render threads.
+    GPUScopeRecord frame_scope = BeginGPUScope(command_buffer, GetGPUFrameScope(), GetRenderThreadCount());
     vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
     // Execute entity render commands.
     vkCmdExecuteCommands(command_buffer, frame->render_command_buffers.count, frame->render_command_buffers.data);
 
     vkCmdEndRenderPass(command_buffer);
+    EndGPUScope(command_buffer, frame_scope);
 
     res = vkEndCommandBuffer(command_buffer);
     Validate(res, "vkEndCommandBuffer() failed");
 
-    // Submit commands for rendering to graphics queue.
+    // Defragmentation copies run first so rendering sees resources at their new locations, and readback copies run last
+    // so they see what the frame rendered.
+    FArray<VkCommandBuffer, 3> command_buffers = {};
+    VkCommandBuffer defrag_command_buffer = VK_NULL_HANDLE;
+    if (EndDefragCommands(&defrag_command_buffer))
+    {
+        Push(&command_buffers, defrag_command_buffer);
+    }
+    Push(&command_buffers, command_buffer);
+    VkCommandBuffer readback_command_buffer = VK_NULL_HANDLE;
+    if (EndReadbackCommands(&readback_command_buffer))
+    {
+        Push(&command_buffers, readback_command_buffer);
+    }
+
+    // Host writes to non-coherent memory made while recording frame must be flushed before the device reads them.
+    MarkTransientAllocationsWritten();
+    FlushHostWrites();
+
+    // Submit commands for rendering to graphics queue, signaling frame's timeline value once they complete along with
+    // acquired swapchain image's render_finished for presentation. Headless submissions have no acquire/present
+    // semaphores.
+    bool headless = IsHeadless();
+    VkSemaphore render_finished = headless
+                                  ? VK_NULL_HANDLE
+                                  : Get(&GetSwapchain()->render_finished, frame->swapchain_image_index);
+    VkSemaphore signal_semaphores[] = { GetFrameTimeline(), render_finished };
+    uint64 signal_values[] = { SignalNextFrameValue(), 0 }; // Binary semaphore values are ignored.
+    VkTimelineSemaphoreSubmitInfo timeline_info =
+    {
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext                     = NULL,
+        .waitSemaphoreValueCount   = 0,
+        .pWaitSemaphoreValues      = NULL,
+        .signalSemaphoreValueCount = headless ? 1u : 2u,
+        .pSignalSemaphoreValues    = signal_values,
+    };
     VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     VkSubmitInfo submit_info =
     {
         .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext                = NULL,
-        .waitSemaphoreCount   = 1,
-        .pWaitSemaphores      = &frame->image_acquired,
-        .pWaitDstStageMask    = &wait_stage,
-        .commandBufferCount   = 1,
-        .pCommandBuffers      = &command_buffer,
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores    = &frame->render_finished,
+        .pNext                = &timeline_info,
+        .waitSemaphoreCount   = headless ? 0u : 1u,
+        .pWaitSemaphores      = headless ? NULL : &frame->image_acquired,
+        .pWaitDstStageMask    = headless ? NULL : &wait_stage,
+        .commandBufferCount   = command_buffers.count,
+        .pCommandBuffers      = command_buffers.data,
+        .signalSemaphoreCount = headless ? 1u : 2u,
+        .pSignalSemaphores    = signal_semaphores,
     };
-    res = vkQueueSubmit(GetGraphicsQueue(), 1, &submit_info, frame->command_buffers_complete);
-    Validate(res, "vkQueueSubmit() failed");
+    {
+        RTK_TRACE_SCOPE("QueueSubmit");
+        res = vkQueueSubmit(GetGraphicsQueue(), 1, &submit_info, VK_NULL_HANDLE);
+        Validate(res, "vkQueueSubmit() failed");
+    }
+
+    if (headless)
+    {
+        Set(&GetSwapchain()->image_frame_values, frame->swapchain_image_index, signal_values[0]);
+        return res;
+    }
 
     // Queue swapchain image for presentation.
     VkPresentInfoKHR present_info =
@@ -190,13 +273,16 @@ static VkResult SubmitRenderCommands(RenderTarget* render_target)
         .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
         .pNext              = NULL,
         .waitSemaphoreCount = 1,
-        .pWaitSemaphores    = &frame->render_finished,
+        .pWaitSemaphores    = &render_finished,
         .swapchainCount     = 1,
         .pSwapchains        = &GetSwapchain()->hnd,
         .pImageIndices      = &frame->swapchain_image_index,
         .pResults           = NULL,
     };
-    res = vkQueuePresentKHR(GetGraphicsQueue(), &present_info);
+    {
+        RTK_TRACE_SCOPE("QueuePresent");
+        res = vkQueuePresentKHR(GetGraphicsQueue(), &present_info);
+    }
     if (res != VK_SUBOPTIMAL_KHR && res != VK_ERROR_OUT_OF_DATE_KHR)
     {
         Validate(res, "vkQueuePresentKHR() failed");
@@ -3,10 +3,19 @@
 static constexpr VkDeviceSize USE_MIN_OFFSET_ALIGNMENT = 0;
 static constexpr uint32 MAX_RESOURCE_GROUPS = 0xFF;
 static constexpr uint32 MAX_RESOURCES       = 0xFFFFFF;
-
-struct BufferHnd        { uint32 group_index : 8; uint32 index : 24; };
+static constexpr uint32 DEFAULT_MAX_PENDING_DESTROYS = 256;
+static constexpr uint32 DEFAULT_MAX_PAGES = 16;
+static constexpr VkDeviceSize DEFAULT_PAGE_SIZE = 64 * 1024 * 1024;
+static constexpr uint32 MAX_MAPPED_RANGE_BATCH = 64;
+static constexpr VkDeviceSize MAX_AUTO_DEVICE_LOCAL_HOST_SIZE = 1024 * 1024; // Per-frame size.
+static constexpr uint32 MAX_MEM_REQUIREMENTS_CACHE_ENTRIES = 64;
+
+// Buffer and image slots are reused once their resource is destroyed, so their handles also carry the slot's generation
+// at creation. Destroying a resource bumps its slot's generation, so stale handles fail validation instead of aliasing
+// whatever resource reuses the slot.
+struct BufferHnd        { uint32 group_index : 8; uint32 index : 24; uint32 generation; };
 struct ImageMemoryHnd   { uint32 group_index : 8; uint32 index : 24; };
-struct ImageHnd         { uint32 group_index : 8; uint32 index : 24; };
+struct ImageHnd         { uint32 group_index : 8; uint32 index : 24; uint32 generation; };
 struct ResourceGroupHnd { uint32 index; };
 
 // From https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#resources-association:
@@ -24,22 +33,35 @@ struct BufferInfo
     bool                  per_frame;
     VkBufferCreateFlags   flags;
     VkBufferUsageFlags    usage;
-    VkMemoryPropertyFlags properties;
+    VkMemoryPropertyFlags properties;           // Required.
+    VkMemoryPropertyFlags preferred_properties; // Used if a memory type with required properties also has them.
 };
 
 struct BufferState
 {
-    VkDeviceSize size;
-    VkDeviceSize alignment;
-    uint32       res_mem_index;
-    uint32       frame_stride;
-    uint32       frame_count;
+    VkDeviceSize  size;
+    VkDeviceSize  alignment;
+    uint32        res_mem_index;
+    uint32        frame_stride;
+    uint32        frame_count;
+    uint32        parent_index; // UNSET_INDEX for buffers defined with DefineBuffer().
+    uint32        page_index;   // UNSET_INDEX unless memory is in a resource memory page.
+    Suballocator* suballocator; // Suballocator frames' ranges came from; NULL for buffers defined with DefineBuffer().
+};
+
+// Buffer's memory requirements and memory type, resolved before taking group's lock.
+struct BufferDefinition
+{
+    VkMemoryRequirements mem_requirements;
+    VkBufferUsageFlags   usage;
+    uint32               res_mem_index;
 };
 
 struct BufferFrameState
 {
-    VkDeviceSize res_mem_offset;
+    VkDeviceSize res_mem_offset; // Offset in buffer returned by GetBuffer().
     VkDeviceSize index;
+    uint32       suballocation; // Block index in parent buffer's suballocator.
 };
 
 // From https://registry.khronos.org/vulkan/specs/1.3-extensions/html/vkspec.html#resources-association:
@@ -63,7 +85,8 @@ struct ImageMemoryInfo
     VkDeviceSize          size;
     VkImageCreateFlags    flags;
     VkImageUsageFlags     usage;
-    VkMemoryPropertyFlags properties;
+    VkMemoryPropertyFlags properties;           // Required.
+    VkMemoryPropertyFlags preferred_properties; // Used if a memory type with required properties also has them.
     VkFormat              format;
     VkImageTiling         tiling;
 };
@@ -71,7 +94,6 @@ struct ImageMemoryInfo
 struct ImageMemoryState
 {
     VkDeviceSize size;
-    VkDeviceSize index;
     VkDeviceSize res_mem_offset;
     uint32       res_mem_index;
 };
@@ -92,8 +114,10 @@ struct ImageState
     VkDeviceSize size;
     VkDeviceSize alignment;
     uint32       image_mem_index;
+    uint32       page_index; // UNSET_INDEX unless memory is in a resource memory page.
     uint32       frame_stride;
     uint32       frame_count;
+    bool         dedicated;  // Frame images have their own device memory instead of suballocated ranges.
 };
 
 struct ImageViewInfo
@@ -106,9 +130,18 @@ struct ImageViewInfo
 
 struct ImageFrameState
 {
-    VkDeviceSize image_mem_offset;
-    VkImage      image;
-    VkImageView  view;
+    VkDeviceSize   image_mem_offset; // Offset in page instead of image memory if image is in a page.
+    VkImage        image;
+    VkImageView    view;
+    uint32         suballocation;    // Block index in image memory's or page's suballocator.
+    VkDeviceMemory dedicated_mem;    // VK_NULL_HANDLE unless image is dedicated.
+};
+
+// Range of mapped non-coherent memory written by the host since it was last flushed; empty if end is 0.
+struct DirtyRange
+{
+    VkDeviceSize start;
+    VkDeviceSize end;
 };
 
 struct ResourceMemory
@@ -120,45 +153,144 @@ struct ResourceMemory
     uint8*                mapped;
     VkBufferUsageFlags    buffer_usage;
     VkBuffer              buffer;
+    VkDeviceAddress       buffer_address; // Device address of buffer's first byte; 0 if memory has no buffer.
+    DirtyRange            dirty_range;
+};
+
+// Fixed-size device memory block allocated once a parent buffer or image memory is full. Pages of the same memory type
+// are linked into a list starting at ResourceGroup::first_page_indexes[res_mem_index].
+struct ResourceMemoryPage
+{
+    VkDeviceSize    size;
+    uint32          res_mem_index;
+    uint32          next_page_index;
+    VkDeviceMemory  hnd;
+    uint8*          mapped;
+    VkBuffer        buffer;
+    VkDeviceAddress buffer_address;
+    Suballocator*   suballocator;
+    DirtyRange      dirty_range;
 };
 
 struct ResourceGroupInfo
 {
-    uint32 max_buffers;
-    uint32 max_image_mems;
-    uint32 max_images;
+    uint32       max_buffers;
+    uint32       max_image_mems;
+    uint32       max_images;
+    uint32       max_pages; // Uses DEFAULT_MAX_PAGES if 0.
+    VkDeviceSize page_size; // Uses DEFAULT_PAGE_SIZE if 0; larger resources get pages large enough to fit them.
+};
+
+// Guards resource bookkeeping so resources can be created from worker threads. Critical sections only update counts,
+// free lists and suballocators (plus the occasional page allocation), so waiters spin instead of sleeping.
+//
+// Safe to call concurrently on the same group: DefineBuffer(s)(), DefineImageMemory(), CreateBuffer(), CreateImage(s)()
+// and anything taking a handle to a live resource. Slot counts and generations are only written under the lock, with
+// release stores, so handles are validated lock-free with acquire loads. Everything else (AllocateResourceGroup(),
+// DestroyBuffer(), DestroyImage(), deallocating or retiring groups, defragmentation) must be called from the main
+// thread, and allocating, deallocating or retiring a group additionally requires no worker thread to be using it.
+struct alignas(64) ResourceLock
+{
+    std::atomic<bool> locked;
 };
 
 struct ResourceGroup
 {
-    uint32             max_buffers;
-    uint32             buffer_count;
-    BufferInfo*        buffer_infos;        // size: max_buffers
-    BufferState*       buffer_states;       // size: max_buffers
-    BufferFrameState*  buffer_frame_states; // size: max_buffers * frame_count
-
-    uint32             max_image_mems;
-    uint32             image_mem_count;
-    ImageMemoryInfo*   image_mem_infos;
-    ImageMemoryState*  image_mem_states;
-
-    uint32             max_images;
-    uint32             image_count;
-    ImageInfo*         image_infos;         // size: max_images
-    ImageViewInfo*     image_view_infos;    // size: max_images
-    ImageState*        image_states;        // size: max_images
-    ImageFrameState*   image_frame_states;  // size: max_images * frame_count
-
-    ResourceMemory     res_mems[VK_MAX_MEMORY_TYPES];
-    uint32             frame_count;
+    uint32               max_buffers;
+    std::atomic<uint32>  buffer_count;
+    BufferInfo*          buffer_infos;        // size: max_buffers
+    BufferState*         buffer_states;       // size: max_buffers
+    BufferFrameState*    buffer_frame_states; // size: max_buffers * frame_count
+    std::atomic<uint32>* buffer_generations;  // size: max_buffers
+
+    uint32               max_image_mems;
+    uint32               image_mem_count;
+    ImageMemoryInfo*     image_mem_infos;
+    ImageMemoryState*    image_mem_states;
+
+    uint32               max_images;
+    std::atomic<uint32>  image_count;
+    ImageInfo*           image_infos;         // size: max_images
+    ImageViewInfo*       image_view_infos;    // size: max_images
+    ImageState*          image_states;        // size: max_images
+    ImageFrameState*     image_frame_states;  // size: max_images * frame_count
+    std::atomic<uint32>* image_generations;   // size: max_images
+
+    ResourceMemory       res_mems[VK_MAX_MEMORY_TYPES];
+    uint32               frame_count;
+
+    // Sub-buffers and images are suballocated from their parent buffer/image memory, and their slots are reused once
+    // they're destroyed. Suballocators are created on first use and reset when their slot is redefined.
+    Allocator*           allocator;
+    Suballocator**       buffer_suballocators;    // size: max_buffers
+    uint32*              free_buffer_indexes;     // size: max_buffers
+    uint32               free_buffer_count;
+    Suballocator**       image_mem_suballocators; // size: max_image_mems
+    uint32*              free_image_indexes;      // size: max_images
+    uint32               free_image_count;
+
+    // Resources that don't fit in their parent buffer/image memory are suballocated from pages instead, so groups can
+    // grow after being allocated without changing existing handles. Pages are kept until the group is deallocated.
+    uint32               max_pages;
+    uint32               page_count;
+    VkDeviceSize         page_size;
+    ResourceMemoryPage*  pages;                                  // size: max_pages
+    uint32               first_page_indexes[VK_MAX_MEMORY_TYPES]; // UNSET_INDEX if memory type has no pages.
+
+    // Held while reserving slots, growing resource memory and suballocating; driver calls for each resource's own
+    // VkImage/VkImageView and memory binding happen outside it.
+    ResourceLock*        lock;
 };
 
 struct ResourceModuleInfo
 {
     uint32 max_resource_groups;
+    uint32 max_pending_destroys; // Uses DEFAULT_MAX_PENDING_DESTROYS if 0.
 };
 
-static Array<ResourceGroup> g_res_groups;
+// Buffers and images created with the same parameters share memory type bits (see spec excerpts above BufferInfo and
+// ImageMemoryInfo), so they're queried once per combination and cached. Buffers also share alignment.
+struct MemoryRequirementsKey
+{
+    bool          image;
+    uint32        flags;
+    uint32        usage;
+    VkFormat      format; // VK_FORMAT_UNDEFINED for buffers.
+    VkImageTiling tiling; // VK_IMAGE_TILING_OPTIMAL for buffers.
+};
+
+struct CachedMemoryRequirements
+{
+    MemoryRequirementsKey key;
+    uint32                mem_type_bits;
+    VkDeviceSize          alignment; // 0 for images; image alignment depends on image shape.
+};
+
+enum struct PendingDestroyType
+{
+    BUFFER,
+    IMAGE,
+};
+
+// Destroyed resources may still be referenced by in-flight frames, so their memory and slots are reclaimed once the
+// frame timeline reaches frame_value.
+struct PendingDestroy
+{
+    PendingDestroyType type;
+    uint32             group_index;
+    uint32             index;
+    uint64             frame_value;
+};
+
+static Array<ResourceGroup>  g_res_groups;
+static Array<PendingDestroy> g_pending_destroys;
+static Array<CachedMemoryRequirements> g_mem_requirements_cache;
+static ResourceLock g_mem_requirements_cache_lock;
+
+/// Forward Declarations
+////////////////////////////////////////////////////////////
+static void InitHeadlessSwapchainImages(Allocator* allocator);
+static void DropDefragmenterMoves(uint32 group_index, bool destroy_images);
 
 /// Utils
 ////////////////////////////////////////////////////////////
@@ -173,10 +305,59 @@ static ResourceMemory* GetResourceMemory(ResourceGroup* res_group, uint32 res_me
     return &res_group->res_mems[res_mem_index];
 }
 
-static uint32 GetCapableMemoryTypeIndex(VkMemoryRequirements* mem_requirements, VkMemoryPropertyFlags mem_properties)
+static void LockResources(ResourceLock* lock)
+{
+    while (lock->locked.exchange(true, std::memory_order_acquire))
+    {
+        // Spin on a plain load so waiting threads don't keep stealing the cache line from the owner.
+        while (lock->locked.load(std::memory_order_relaxed)) {}
+    }
+}
+
+static void UnlockResources(ResourceLock* lock)
+{
+    lock->locked.store(false, std::memory_order_release);
+}
+
+static uint32 CountSetBits(uint32 bits)
+{
+    uint32 count = 0;
+    for (; bits != 0; bits &= bits - 1)
+    {
+        ++count;
+    }
+    return count;
+}
+
+// Higher is better. Each preferred property outweighs all unrequested ones, and unrequested properties are penalized so
+// exact matches win. Device local host visible memory (often a small BAR heap) is only used when device local or host
+// visible memory is explicitly asked for alongside the other.
+static sint32 ScoreMemoryType(VkMemoryPropertyFlags type_properties, VkMemoryPropertyFlags properties,
+                              VkMemoryPropertyFlags preferred_properties)
+{
+    static constexpr VkMemoryPropertyFlags DEVICE_LOCAL_HOST_VISIBLE = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    VkMemoryPropertyFlags requested_properties = properties | preferred_properties;
+    VkMemoryPropertyFlags unrequested_properties = type_properties & ~requested_properties;
+    sint32 score = (sint32)CountSetBits(type_properties & preferred_properties) * 32;
+    score -= (sint32)CountSetBits(unrequested_properties);
+    if ((type_properties & DEVICE_LOCAL_HOST_VISIBLE) == DEVICE_LOCAL_HOST_VISIBLE &&
+        (requested_properties & DEVICE_LOCAL_HOST_VISIBLE) != DEVICE_LOCAL_HOST_VISIBLE)
+    {
+        score -= 16;
+    }
+    return score;
+}
+
+// Picks highest scoring memory type with all required properties (see ScoreMemoryType()), so placement doesn't depend
+// on the order memory types are enumerated in.
+static uint32 GetCapableMemoryTypeIndex(VkMemoryRequirements* mem_requirements, VkMemoryPropertyFlags mem_properties,
+                                        VkMemoryPropertyFlags preferred_mem_properties)
 {
     // Reference: https://registry.khronos.org/vulkan/specs/1.3/html/vkspec.html#memory-device
     VkPhysicalDeviceMemoryProperties* device_mem_properties = &GetPhysicalDevice()->mem_properties;
+    uint32 best_mem_type_index = UNSET_INDEX;
+    sint32 best_score = 0;
     for (uint32 mem_type_index = 0; mem_type_index < device_mem_properties->memoryTypeCount; ++mem_type_index)
     {
         // Memory type at index must be supported for resource.
@@ -186,18 +367,31 @@ static uint32 GetCapableMemoryTypeIndex(VkMemoryRequirements* mem_requirements,
         }
 
         // Memory type at index must support all resource memory properties.
-        if ((device_mem_properties->memoryTypes[mem_type_index].propertyFlags & mem_properties) != mem_properties)
+        VkMemoryPropertyFlags type_properties = device_mem_properties->memoryTypes[mem_type_index].propertyFlags;
+        if ((type_properties & mem_properties) != mem_properties)
         {
             continue;
         }
 
-        return mem_type_index;
+        // Ties go to the first enumerated type, which the spec orders by performance.
+        sint32 score = ScoreMemoryType(type_properties, mem_properties, preferred_mem_properties);
+        if (best_mem_type_index == UNSET_INDEX || score > best_score)
+        {
+            best_mem_type_index = mem_type_index;
+            best_score          = score;
+        }
     }
 
-    CTK_FATAL("failed to find memory type that satisfies requested memory requirements & properties");
+    if (best_mem_type_index == UNSET_INDEX)
+    {
+        CTK_FATAL("failed to find memory type that satisfies requested memory requirements & properties");
+    }
+    return best_mem_type_index;
 }
 
-static VkDeviceMemory AllocateDeviceMemory(uint32 mem_type_index, VkDeviceSize size, VkAllocationCallbacks* allocators)
+static VkDeviceMemory AllocateDeviceMemory(uint32 mem_type_index, VkDeviceSize size, VkAllocationCallbacks* allocators,
+                                           VkMemoryDedicatedAllocateInfo* dedicated_info = NULL,
+                                           VkMemoryAllocateFlags flags = 0)
 {
     // From https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkAllocateMemory.html:
     // Allocations returned by vkAllocateMemory are guaranteed to meet any alignment requirement of the implementation.
@@ -206,10 +400,21 @@ static VkDeviceMemory AllocateDeviceMemory(uint32 mem_type_index, VkDeviceSize s
     // correctly suballocate objects of different types (with potentially different alignment requirements) in the same
     // memory object.
 
+    // Memory bound to buffers with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT needs
+    // VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT.
+    VkMemoryAllocateFlagsInfo flags_info =
+    {
+        .sType      = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+        .pNext      = dedicated_info,
+        .flags      = flags,
+        .deviceMask = 0,
+    };
+
     // Allocate memory using selected memory type index.
     VkMemoryAllocateInfo info =
     {
         .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext           = flags != 0 ? (void*)&flags_info : (void*)dedicated_info,
         .allocationSize  = size,
         .memoryTypeIndex = mem_type_index,
     };
@@ -220,20 +425,461 @@ static VkDeviceMemory AllocateDeviceMemory(uint32 mem_type_index, VkDeviceSize s
     return mem;
 }
 
-static VkDeviceSize AllocateImageMemory(ImageMemoryState* image_mem_state, ImageState* image_state)
+static VkDeviceAddress GetDeviceAddress(VkBuffer buffer)
+{
+    VkBufferDeviceAddressInfo info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .pNext  = NULL,
+        .buffer = buffer,
+    };
+    return vkGetBufferDeviceAddress(GetDevice(), &info);
+}
+
+// Returns true if the driver prefers or requires resource to have its own allocation, which lets it place and
+// compress render targets and large images better.
+static bool QueryImageMemoryRequirements(VkImage image, VkMemoryRequirements* mem_requirements)
+{
+    VkMemoryDedicatedRequirements dedicated_requirements =
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+        .pNext = NULL,
+    };
+    VkMemoryRequirements2 mem_requirements2 =
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicated_requirements,
+    };
+    VkImageMemoryRequirementsInfo2 info =
+    {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
+        .pNext = NULL,
+        .image = image,
+    };
+    vkGetImageMemoryRequirements2(GetDevice(), &info, &mem_requirements2);
+    *mem_requirements = mem_requirements2.memoryRequirements;
+    return dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation;
+}
+
+static bool QueryBufferMemoryRequirements(VkBuffer buffer, VkMemoryRequirements* mem_requirements)
+{
+    VkMemoryDedicatedRequirements dedicated_requirements =
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+        .pNext = NULL,
+    };
+    VkMemoryRequirements2 mem_requirements2 =
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicated_requirements,
+    };
+    VkBufferMemoryRequirementsInfo2 info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
+        .pNext  = NULL,
+        .buffer = buffer,
+    };
+    vkGetBufferMemoryRequirements2(GetDevice(), &info, &mem_requirements2);
+    *mem_requirements = mem_requirements2.memoryRequirements;
+    return dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation;
+}
+
+static void GetImageCreateInfo(VkImageCreateInfo* image_create_info, ImageMemoryInfo* image_mem_info,
+                               ImageInfo* image_info)
+{
+    ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
+    image_create_info->sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_create_info->pNext                 = NULL;
+    image_create_info->flags                 = image_mem_info  ->flags;
+    image_create_info->format                = image_mem_info  ->format;
+    image_create_info->tiling                = image_mem_info  ->tiling;
+    image_create_info->usage                 = image_mem_info  ->usage;
+    image_create_info->imageType             = image_info      ->type;
+    image_create_info->extent                = image_info      ->extent;
+    image_create_info->mipLevels             = image_info      ->mip_levels;
+    image_create_info->arrayLayers           = image_info      ->array_layers;
+    image_create_info->samples               = image_info      ->samples;
+    image_create_info->initialLayout         = image_info      ->initial_layout;
+    image_create_info->sharingMode           = resource_sharing->mode;
+    image_create_info->queueFamilyIndexCount = resource_sharing->queue_family_index_count;
+    image_create_info->pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
+}
+
+// Queries requirements of an image that hasn't been created. Vulkan 1.3 devices answer directly; older devices need a
+// temporary image.
+static bool QueryImageMemoryRequirements(VkImageCreateInfo* image_create_info, VkMemoryRequirements* mem_requirements)
+{
+    VkDevice device = GetDevice();
+    if (GetDeviceAPIVersion() < VK_API_VERSION_1_3)
+    {
+        VkImage temp = VK_NULL_HANDLE;
+        VkResult res = vkCreateImage(device, image_create_info, NULL, &temp);
+        Validate(res, "vkCreateImage() failed");
+        bool dedicated = QueryImageMemoryRequirements(temp, mem_requirements);
+        vkDestroyImage(device, temp, NULL);
+        return dedicated;
+    }
+
+    VkMemoryDedicatedRequirements dedicated_requirements =
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS,
+        .pNext = NULL,
+    };
+    VkMemoryRequirements2 mem_requirements2 =
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicated_requirements,
+    };
+    VkDeviceImageMemoryRequirements info =
+    {
+        .sType       = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+        .pNext       = NULL,
+        .pCreateInfo = image_create_info,
+        .planeAspect = (VkImageAspectFlagBits)0,
+    };
+    vkGetDeviceImageMemoryRequirements(device, &info, &mem_requirements2);
+    *mem_requirements = mem_requirements2.memoryRequirements;
+    return dedicated_requirements.prefersDedicatedAllocation || dedicated_requirements.requiresDedicatedAllocation;
+}
+
+static CachedMemoryRequirements* FindCachedMemoryRequirementsLocked(MemoryRequirementsKey* key)
+{
+    CTK_ITER(cached, &g_mem_requirements_cache)
+    {
+        if (cached->key.image  == key->image  &&
+            cached->key.flags  == key->flags  &&
+            cached->key.usage  == key->usage  &&
+            cached->key.format == key->format &&
+            cached->key.tiling == key->tiling)
+        {
+            return cached;
+        }
+    }
+    return NULL;
+}
+
+// Entries are never modified once pushed, so returned entries can be read after the lock is released.
+static CachedMemoryRequirements* FindCachedMemoryRequirements(MemoryRequirementsKey* key)
+{
+    LockResources(&g_mem_requirements_cache_lock);
+    CachedMemoryRequirements* cached = FindCachedMemoryRequirementsLocked(key);
+    UnlockResources(&g_mem_requirements_cache_lock);
+    return cached;
+}
+
+static void CacheMemoryRequirements(MemoryRequirementsKey* key, VkMemoryRequirements* mem_requirements)
+{
+    // Threads that missed on the same combination query it concurrently; only the first result is cached.
+    // Combinations past the cache's capacity are just queried every time.
+    LockResources(&g_mem_requirements_cache_lock);
+    if (FindCachedMemoryRequirementsLocked(key) == NULL && CanPush(&g_mem_requirements_cache, 1))
+    {
+        Push(&g_mem_requirements_cache,
+        {
+            .key           = *key,
+            .mem_type_bits = mem_requirements->memoryTypeBits,
+            .alignment     = key->image ? 0 : mem_requirements->alignment,
+        });
+    }
+    UnlockResources(&g_mem_requirements_cache_lock);
+}
+
+// Buffers are suballocated from their memory's shared VkBuffer, so only memory type bits and alignment matter and size
+// is just aligned.
+static void GetBufferMemoryRequirements(VkMemoryRequirements* mem_requirements, VkDeviceSize size,
+                                        VkBufferUsageFlags usage)
+{
+    MemoryRequirementsKey key =
+    {
+        .image  = false,
+        .flags  = 0,
+        .usage  = usage,
+        .format = VK_FORMAT_UNDEFINED,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+    };
+    CachedMemoryRequirements* cached = FindCachedMemoryRequirements(&key);
+    if (cached == NULL)
+    {
+        ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
+        VkBufferCreateInfo buffer_create_info = {};
+        buffer_create_info.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_create_info.pNext                 = NULL;
+        buffer_create_info.flags                 = 0;
+        buffer_create_info.size                  = size;
+        buffer_create_info.usage                 = usage;
+        buffer_create_info.sharingMode           = resource_sharing->mode;
+        buffer_create_info.queueFamilyIndexCount = resource_sharing->queue_family_index_count;
+        buffer_create_info.pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
+
+        // Vulkan 1.3 devices answer directly; older devices need a temporary buffer.
+        VkDevice device = GetDevice();
+        if (GetDeviceAPIVersion() >= VK_API_VERSION_1_3)
+        {
+            VkDeviceBufferMemoryRequirements info =
+            {
+                .sType       = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS,
+                .pNext       = NULL,
+                .pCreateInfo = &buffer_create_info,
+            };
+            VkMemoryRequirements2 mem_requirements2 =
+            {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+                .pNext = NULL,
+            };
+            vkGetDeviceBufferMemoryRequirements(device, &info, &mem_requirements2);
+            *mem_requirements = mem_requirements2.memoryRequirements;
+        }
+        else
+        {
+            VkBuffer temp = VK_NULL_HANDLE;
+            VkResult res = vkCreateBuffer(device, &buffer_create_info, NULL, &temp);
+            Validate(res, "vkCreateBuffer() failed");
+            vkGetBufferMemoryRequirements(device, temp, mem_requirements);
+            vkDestroyBuffer(device, temp, NULL);
+        }
+        CacheMemoryRequirements(&key, mem_requirements);
+    }
+    else
+    {
+        mem_requirements->memoryTypeBits = cached->mem_type_bits;
+        mem_requirements->alignment      = cached->alignment;
+    }
+    mem_requirements->size = Align(size, mem_requirements->alignment);
+}
+
+// Memory type bits of images created with image memory's parameters, queried with a minimal 2D image (valid for cube
+// compatible flags, given 6 layers, and depth formats, unlike 1D). Size and alignment depend on image shape, so they're
+// left 0; images take their own from vkGetImageMemoryRequirements() when created.
+static void GetImageMemoryTypeRequirements(VkMemoryRequirements* mem_requirements, ImageMemoryInfo* image_mem_info)
+{
+    MemoryRequirementsKey key =
+    {
+        .image  = true,
+        .flags  = image_mem_info->flags,
+        .usage  = image_mem_info->usage,
+        .format = image_mem_info->format,
+        .tiling = image_mem_info->tiling,
+    };
+    CachedMemoryRequirements* cached = FindCachedMemoryRequirements(&key);
+    if (cached != NULL)
+    {
+        mem_requirements->size           = 0;
+        mem_requirements->alignment      = 0;
+        mem_requirements->memoryTypeBits = cached->mem_type_bits;
+        return;
+    }
+
+    ImageInfo image_info =
+    {
+        .extent         = { 1, 1, 1 },
+        .type           = VK_IMAGE_TYPE_2D,
+        .mip_levels     = 1,
+        .array_layers   = image_mem_info->flags & VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT ? 6u : 1u,
+        .samples        = VK_SAMPLE_COUNT_1_BIT,
+        .initial_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .per_frame      = false,
+    };
+    VkImageCreateInfo image_create_info = {};
+    GetImageCreateInfo(&image_create_info, image_mem_info, &image_info);
+    QueryImageMemoryRequirements(&image_create_info, mem_requirements);
+    CacheMemoryRequirements(&key, mem_requirements);
+    mem_requirements->size      = 0;
+    mem_requirements->alignment = 0;
+}
+
+// Must be called while holding group's lock.
+static uint32 PopFreeIndex(uint32* free_indexes, uint32* free_count, std::atomic<uint32>* count, uint32 max_count,
+                           const char* resource_name)
+{
+    // Reuse slots of destroyed resources before growing count.
+    if (*free_count > 0)
+    {
+        *free_count -= 1;
+        return free_indexes[*free_count];
+    }
+    uint32 index = count->load(std::memory_order_relaxed);
+    if (index >= max_count)
+    {
+        CTK_FATAL("can't create %s: already at max of %u %ss", resource_name, max_count, resource_name);
+    }
+
+    count->store(index + 1, std::memory_order_release);
+    return index;
+}
+
+static void PushPendingDestroy(PendingDestroyType type, uint32 group_index, uint32 index)
+{
+    if (!CanPush(&g_pending_destroys, 1))
+    {
+        CTK_FATAL("can't destroy resource: pending destroy count has reached max of %u", g_pending_destroys.size);
+    }
+
+    // Resource may be referenced by any frame submitted so far, as well as the frame currently being recorded.
+    Push(&g_pending_destroys,
+    {
+        .type        = type,
+        .group_index = group_index,
+        .index       = index,
+        .frame_value = GetSubmittedFrameValue() + 1,
+    });
+}
+
+static void DropPendingDestroys(uint32 group_index)
+{
+    // Resources of deallocated groups are freed along with the group, so their pending destroys are discarded.
+    uint32 remaining_count = 0;
+    for (uint32 i = 0; i < g_pending_destroys.count; ++i)
+    {
+        PendingDestroy* pending_destroy = GetPtr(&g_pending_destroys, i);
+        if (pending_destroy->group_index != group_index)
+        {
+            Set(&g_pending_destroys, remaining_count, *pending_destroy);
+            ++remaining_count;
+        }
+    }
+    g_pending_destroys.count = remaining_count;
+}
+
+/// Page Utils
+////////////////////////////////////////////////////////////
+static ResourceMemoryPage* GetResourceMemoryPage(ResourceGroup* res_group, uint32 page_index)
 {
-    VkDeviceSize res_mem_relative_index = image_mem_state->res_mem_offset + image_mem_state->index;
-    VkDeviceSize image_mem_offset =
-        Align(res_mem_relative_index, image_state->alignment) - image_mem_state->res_mem_offset;
-    if (image_mem_offset + image_state->size > image_mem_state->size)
+    CTK_ASSERT(page_index < res_group->page_count);
+    return &res_group->pages[page_index];
+}
+
+static bool SuballocateFrames(Suballocation* suballocations, Suballocator* suballocator, uint32 frame_count,
+                              VkDeviceSize size, VkDeviceSize alignment)
+{
+    // All frames of a resource must come from the same memory, so partial suballocations are undone on failure.
+    for (uint32 frame_index = 0; frame_index < frame_count; ++frame_index)
+    {
+        if (!Suballocate(&suballocations[frame_index], suballocator, size, alignment))
+        {
+            for (uint32 i = 0; i < frame_index; ++i)
+            {
+                FreeSuballocation(suballocator, suballocations[i].block_index);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32 AllocateResourceMemoryPage(ResourceGroup* res_group, uint32 res_mem_index, VkDeviceSize min_size)
+{
+    if (res_group->page_count >= res_group->max_pages)
+    {
+        CTK_FATAL("can't allocate resource memory page: already at max of %u pages", res_group->max_pages);
+    }
+
+    VkDevice device = GetDevice();
+    ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
+    VkResult res = VK_SUCCESS;
+
+    ResourceMemory* res_mem = GetResourceMemory(res_group, res_mem_index);
+    uint32 page_index = res_group->page_count;
+    res_group->page_count += 1;
+
+    ResourceMemoryPage* page = GetResourceMemoryPage(res_group, page_index);
+    page->size           = Max(res_group->page_size, min_size);
+    page->res_mem_index  = res_mem_index;
+    page->mapped         = NULL;
+    page->buffer         = VK_NULL_HANDLE;
+    page->buffer_address = 0;
+    page->dirty_range    = {};
+
+    // Pages get a buffer with the same usage as resource memory's buffer so any of its sub-buffers can be placed here.
+    if (res_mem->buffer_usage != 0)
     {
-        CTK_FATAL("can't allocate %u bytes from image memory at %u-byte aligned offset of %u: allocation would exceed "
-                  "image memory size of %u",
-                  image_state->size, image_state->alignment, image_mem_offset, image_mem_state->size);
+        VkBufferCreateInfo buffer_create_info = {};
+        buffer_create_info.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_create_info.pNext                 = NULL;
+        buffer_create_info.flags                 = 0;
+        buffer_create_info.size                  = page            ->size;
+        buffer_create_info.usage                 = res_mem         ->buffer_usage;
+        buffer_create_info.sharingMode           = resource_sharing->mode;
+        buffer_create_info.queueFamilyIndexCount = resource_sharing->queue_family_index_count;
+        buffer_create_info.pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
+
+        res = vkCreateBuffer(device, &buffer_create_info, NULL, &page->buffer);
+        Validate(res, "vkCreateBuffer() failed");
+        VkMemoryRequirements mem_requirements = {};
+        vkGetBufferMemoryRequirements(device, page->buffer, &mem_requirements);
+        CTK_ASSERT(mem_requirements.memoryTypeBits & (1 << res_mem_index));
+        page->size = mem_requirements.size;
     }
 
-    image_mem_state->index = image_mem_offset + image_state->size;
-    return image_mem_offset;
+    page->hnd = AllocateDeviceMemory(res_mem_index, page->size, NULL, NULL,
+                                     page->buffer != VK_NULL_HANDLE ? VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT : 0);
+    if (res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        vkMapMemory(device, page->hnd, 0, page->size, 0, (void**)&page->mapped);
+    }
+    if (page->buffer != VK_NULL_HANDLE)
+    {
+        res = vkBindBufferMemory(device, page->buffer, page->hnd, 0);
+        Validate(res, "vkBindBufferMemory() failed");
+        page->buffer_address = GetDeviceAddress(page->buffer);
+    }
+
+    // Page slots keep their suballocator when the group is reallocated.
+    if (page->suballocator == NULL)
+    {
+        uint32 max_allocations = (res_group->max_buffers + res_group->max_images) * res_group->frame_count;
+        page->suballocator = CreateSuballocator(res_group->allocator, max_allocations, 0, page->size);
+    }
+    else
+    {
+        InitSuballocator(page->suballocator, 0, page->size);
+    }
+
+    // Add page to front of memory type's page list.
+    page->next_page_index = res_group->first_page_indexes[res_mem_index];
+    res_group->first_page_indexes[res_mem_index] = page_index;
+
+    return page_index;
+}
+
+static void ApplyPageGranularity(VkDeviceSize* size, VkDeviceSize* alignment)
+{
+    // Pages hold both buffers and images, so ranges are kept on separate buffer-image granularity pages.
+    VkDeviceSize granularity = GetPhysicalDevice()->properties.limits.bufferImageGranularity;
+    *alignment = Max(*alignment, granularity);
+    *size      = Align(*size, granularity);
+}
+
+// Suballocates frames from the first page of memory type with enough free space, allocating a new page if none have.
+static uint32 SuballocatePageFrames(Suballocation* suballocations, ResourceGroup* res_group, uint32 res_mem_index,
+                                    uint32 frame_count, VkDeviceSize size, VkDeviceSize alignment)
+{
+    ApplyPageGranularity(&size, &alignment);
+
+    for (uint32 page_index = res_group->first_page_indexes[res_mem_index]; page_index != UNSET_INDEX;
+         page_index = GetResourceMemoryPage(res_group, page_index)->next_page_index)
+    {
+        if (SuballocateFrames(suballocations, GetResourceMemoryPage(res_group, page_index)->suballocator, frame_count,
+                              size, alignment))
+        {
+            return page_index;
+        }
+    }
+
+    VkDeviceSize min_size = (Align(size, alignment) * frame_count) + alignment;
+    uint32 page_index = AllocateResourceMemoryPage(res_group, res_mem_index, min_size);
+    if (!SuballocateFrames(suballocations, GetResourceMemoryPage(res_group, page_index)->suballocator, frame_count,
+                           size, alignment))
+    {
+        CTK_FATAL("can't suballocate %u frames of %u bytes from new %u-byte resource memory page", frame_count, size,
+                  GetResourceMemoryPage(res_group, page_index)->size);
+    }
+    return page_index;
+}
+
+static void ResetResourceMemoryPages(ResourceGroup* res_group)
+{
+    res_group->page_count = 0;
+    memset(res_group->first_page_indexes, 0xFF, sizeof(res_group->first_page_indexes)); // UNSET_INDEX
 }
 
 /// Buffer Utils
@@ -256,7 +902,173 @@ static BufferFrameState* GetBufferFrameState(ResourceGroup* res_group, uint32 bu
 
 static VkBuffer GetBuffer(ResourceGroup* res_group, uint32 buffer_index)
 {
-    return GetResourceMemory(res_group, GetBufferState(res_group, buffer_index)->res_mem_index)->buffer;
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    if (buffer_state->page_index != UNSET_INDEX)
+    {
+        return GetResourceMemoryPage(res_group, buffer_state->page_index)->buffer;
+    }
+    return GetResourceMemory(res_group, buffer_state->res_mem_index)->buffer;
+}
+
+// Device address of buffer returned by GetBuffer(), so frame states' res_mem_offset can be added to it.
+static VkDeviceAddress GetBufferBaseDeviceAddress(ResourceGroup* res_group, uint32 buffer_index)
+{
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    if (buffer_state->page_index != UNSET_INDEX)
+    {
+        return GetResourceMemoryPage(res_group, buffer_state->page_index)->buffer_address;
+    }
+    return GetResourceMemory(res_group, buffer_state->res_mem_index)->buffer_address;
+}
+
+// Host memory mapped to buffer returned by GetBuffer(), so frame states' res_mem_offset can index into it.
+static uint8* GetBufferMappedMemory(ResourceGroup* res_group, uint32 buffer_index)
+{
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    if (buffer_state->page_index != UNSET_INDEX)
+    {
+        return GetResourceMemoryPage(res_group, buffer_state->page_index)->mapped;
+    }
+    return GetResourceMemory(res_group, buffer_state->res_mem_index)->mapped;
+}
+
+// Validating a handle is a bounds check and a generation compare; only failures branch further. Render threads validate
+// handles every draw, so count and generation are read with acquire loads instead of taking group's lock, pairing with
+// the release stores made under it when slots are reserved or destroyed.
+static void ValidateBuffer(ResourceGroup* res_group, BufferHnd buffer_hnd, const char* action)
+{
+    uint32 buffer_count = res_group->buffer_count.load(std::memory_order_acquire);
+    uint32 generation = buffer_hnd.index < buffer_count
+                        ? res_group->buffer_generations[buffer_hnd.index].load(std::memory_order_acquire)
+                        : 0;
+    if (buffer_hnd.index < buffer_count && generation == buffer_hnd.generation)
+    {
+        return;
+    }
+
+    if (buffer_hnd.index >= buffer_count)
+    {
+        CTK_FATAL("%s: buffer index %u exceeds buffer count of %u", action, buffer_hnd.index, buffer_count);
+    }
+    CTK_FATAL("%s: buffer %u handle is stale: handle generation is %u but slot is at generation %u", action,
+              buffer_hnd.index, buffer_hnd.generation, generation);
+}
+
+static void ResetBufferSuballocator(ResourceGroup* res_group, uint32 buffer_index)
+{
+    Suballocator* suballocator = res_group->buffer_suballocators[buffer_index];
+    if (suballocator != NULL)
+    {
+        InitSuballocator(suballocator, GetBufferFrameState(res_group, buffer_index, 0)->res_mem_offset,
+                         GetBufferState(res_group, buffer_index)->size);
+    }
+}
+
+static Suballocator* GetBufferSuballocator(ResourceGroup* res_group, uint32 buffer_index)
+{
+    Suballocator** suballocator = &res_group->buffer_suballocators[buffer_index];
+    if (*suballocator == NULL)
+    {
+        *suballocator = CreateSuballocator(res_group->allocator, res_group->max_buffers * res_group->frame_count,
+                                           GetBufferFrameState(res_group, buffer_index, 0)->res_mem_offset,
+                                           GetBufferState(res_group, buffer_index)->size);
+    }
+    return *suballocator;
+}
+
+/// Host Memory Utils
+////////////////////////////////////////////////////////////
+// Host visible memory without HOST_COHERENT needs host writes flushed and device writes invalidated explicitly.
+static bool IsHostNonCoherent(ResourceGroup* res_group, uint32 buffer_index)
+{
+    ResourceMemory* res_mem = GetResourceMemory(res_group, GetBufferState(res_group, buffer_index)->res_mem_index);
+    VkMemoryPropertyFlags host_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    return (res_mem->properties & host_flags) == VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+
+// Ranges passed to vkFlushMappedMemoryRanges()/vkInvalidateMappedMemoryRanges() must be aligned to
+// nonCoherentAtomSize, unless they end at the end of the mapping.
+static VkMappedMemoryRange GetMappedRange(VkDeviceMemory device_mem, VkDeviceSize mem_size, VkDeviceSize start,
+                                          VkDeviceSize end)
+{
+    VkDeviceSize atom_size = GetPhysicalDevice()->properties.limits.nonCoherentAtomSize;
+    VkDeviceSize offset = start - (start % atom_size);
+    end = Align(end, atom_size);
+    return
+    {
+        .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .pNext  = NULL,
+        .memory = device_mem,
+        .offset = offset,
+        .size   = end >= mem_size ? VK_WHOLE_SIZE : end - offset,
+    };
+}
+
+// Range of buffer's mapped memory (offset is relative to GetBufferMappedMemory()).
+static VkMappedMemoryRange GetBufferMappedRange(ResourceGroup* res_group, uint32 buffer_index, VkDeviceSize offset,
+                                                VkDeviceSize size)
+{
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    if (buffer_state->page_index != UNSET_INDEX)
+    {
+        ResourceMemoryPage* page = GetResourceMemoryPage(res_group, buffer_state->page_index);
+        return GetMappedRange(page->hnd, page->size, offset, offset + size);
+    }
+    ResourceMemory* res_mem = GetResourceMemory(res_group, buffer_state->res_mem_index);
+    return GetMappedRange(res_mem->hnd, res_mem->size, offset, offset + size);
+}
+
+// Host writes to non-coherent memory are merged into a single dirty range per device memory allocation, so however
+// many writes a frame makes, FlushHostWrites() flushes each allocation with one range.
+static void MarkBufferWritten(ResourceGroup* res_group, uint32 buffer_index, VkDeviceSize offset, VkDeviceSize size)
+{
+    if (size == 0 || !IsHostNonCoherent(res_group, buffer_index))
+    {
+        return;
+    }
+
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    DirtyRange* dirty_range = buffer_state->page_index != UNSET_INDEX
+                              ? &GetResourceMemoryPage(res_group, buffer_state->page_index)->dirty_range
+                              : &GetResourceMemory(res_group, buffer_state->res_mem_index)->dirty_range;
+    if (dirty_range->end == 0)
+    {
+        dirty_range->start = offset;
+        dirty_range->end   = offset + size;
+    }
+    else
+    {
+        dirty_range->start = Min(dirty_range->start, offset);
+        dirty_range->end   = Max(dirty_range->end, offset + size);
+    }
+}
+
+static void FlushMappedRanges(FArray<VkMappedMemoryRange, MAX_MAPPED_RANGE_BATCH>* ranges)
+{
+    if (ranges->count == 0)
+    {
+        return;
+    }
+
+    VkResult res = vkFlushMappedMemoryRanges(GetDevice(), ranges->count, ranges->data);
+    Validate(res, "vkFlushMappedMemoryRanges() failed");
+    ranges->count = 0;
+}
+
+static void PushDirtyRange(FArray<VkMappedMemoryRange, MAX_MAPPED_RANGE_BATCH>* ranges, VkDeviceMemory device_mem,
+                           VkDeviceSize mem_size, DirtyRange* dirty_range)
+{
+    if (dirty_range->end == 0)
+    {
+        return;
+    }
+
+    if (ranges->count == MAX_MAPPED_RANGE_BATCH)
+    {
+        FlushMappedRanges(ranges);
+    }
+    Push(ranges, GetMappedRange(device_mem, mem_size, dirty_range->start, dirty_range->end));
+    *dirty_range = {};
 }
 
 /// Image Memory Utils
@@ -271,6 +1083,28 @@ static ImageMemoryState* GetImageMemoryState(ResourceGroup* res_group, uint32 im
     return &res_group->image_mem_states[image_mem_index];
 }
 
+static void ResetImageMemorySuballocator(ResourceGroup* res_group, uint32 image_mem_index)
+{
+    Suballocator* suballocator = res_group->image_mem_suballocators[image_mem_index];
+    if (suballocator != NULL)
+    {
+        ImageMemoryState* image_mem_state = GetImageMemoryState(res_group, image_mem_index);
+        InitSuballocator(suballocator, image_mem_state->res_mem_offset, image_mem_state->size);
+    }
+}
+
+static Suballocator* GetImageMemorySuballocator(ResourceGroup* res_group, uint32 image_mem_index)
+{
+    Suballocator** suballocator = &res_group->image_mem_suballocators[image_mem_index];
+    if (*suballocator == NULL)
+    {
+        ImageMemoryState* image_mem_state = GetImageMemoryState(res_group, image_mem_index);
+        *suballocator = CreateSuballocator(res_group->allocator, res_group->max_images * res_group->frame_count,
+                                           image_mem_state->res_mem_offset, image_mem_state->size);
+    }
+    return *suballocator;
+}
+
 /// Image Utils
 ////////////////////////////////////////////////////////////
 static ImageInfo* GetImageInfo(ResourceGroup* res_group, uint32 image_index)
@@ -283,6 +1117,26 @@ static ImageViewInfo* GetImageViewInfo(ResourceGroup* res_group, uint32 image_in
     return &res_group->image_view_infos[image_index];
 }
 
+// Same as ValidateBuffer().
+static void ValidateImage(ResourceGroup* res_group, ImageHnd image_hnd, const char* action)
+{
+    uint32 image_count = res_group->image_count.load(std::memory_order_acquire);
+    uint32 generation = image_hnd.index < image_count
+                        ? res_group->image_generations[image_hnd.index].load(std::memory_order_acquire)
+                        : 0;
+    if (image_hnd.index < image_count && generation == image_hnd.generation)
+    {
+        return;
+    }
+
+    if (image_hnd.index >= image_count)
+    {
+        CTK_FATAL("%s: image index %u exceeds image count of %u", action, image_hnd.index, image_count);
+    }
+    CTK_FATAL("%s: image %u handle is stale: handle generation is %u but slot is at generation %u", action,
+              image_hnd.index, image_hnd.generation, generation);
+}
+
 static ImageState* GetImageState(ResourceGroup* res_group, uint32 image_index)
 {
     return &res_group->image_states[image_index];
@@ -294,12 +1148,56 @@ static ImageFrameState* GetImageFrameState(ResourceGroup* res_group, uint32 imag
     return &res_group->image_frame_states[frame_offset + image_index];
 }
 
+static VkImage CreateFrameImage(ImageMemoryInfo* image_mem_info, ImageInfo* image_info)
+{
+    VkImageCreateInfo image_create_info = {};
+    GetImageCreateInfo(&image_create_info, image_mem_info, image_info);
+
+    VkImage image = VK_NULL_HANDLE;
+    VkResult res = vkCreateImage(GetDevice(), &image_create_info, NULL, &image);
+    Validate(res, "vkCreateImage() failed");
+
+    return image;
+}
+
+static VkImageView CreateFrameImageView(VkImage image, ImageMemoryInfo* image_mem_info, ImageViewInfo* image_view_info)
+{
+    VkImageViewCreateInfo view_create_info =
+    {
+        .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .pNext            = NULL,
+        .flags            = image_view_info->flags,
+        .image            = image,
+        .viewType         = image_view_info->type,
+        .format           = image_mem_info ->format,
+        .components       = image_view_info->components,
+        .subresourceRange = image_view_info->subresource_range,
+    };
+    VkImageView view = VK_NULL_HANDLE;
+    VkResult res = vkCreateImageView(GetDevice(), &view_create_info, NULL, &view);
+    Validate(res, "vkCreateImageView() failed");
+
+    return view;
+}
+
 /// Interface
 ////////////////////////////////////////////////////////////
 static void InitResourceModule(Allocator* allocator, ResourceModuleInfo info)
 {
-    CTK_ASSERT(info.max_resource_groups <= MAX_RESOURCE_GROUPS);
-    g_res_groups = CreateArray<ResourceGroup>(allocator, info.max_resource_groups);
+    // Headless contexts reserve an extra resource group for their offscreen swapchain images.
+    uint32 max_resource_groups = IsHeadless() ? info.max_resource_groups + 1 : info.max_resource_groups;
+    CTK_ASSERT(max_resource_groups <= MAX_RESOURCE_GROUPS);
+    g_res_groups = CreateArray<ResourceGroup>(allocator, max_resource_groups);
+
+    uint32 max_pending_destroys = info.max_pending_destroys > 0 ? info.max_pending_destroys
+                                                                : DEFAULT_MAX_PENDING_DESTROYS;
+    g_pending_destroys = CreateArray<PendingDestroy>(allocator, max_pending_destroys);
+    g_mem_requirements_cache = CreateArray<CachedMemoryRequirements>(allocator, MAX_MEM_REQUIREMENTS_CACHE_ENTRIES);
+
+    if (IsHeadless())
+    {
+        InitHeadlessSwapchainImages(allocator);
+    }
 }
 
 static ResourceGroupHnd CreateResourceGroup(Allocator* allocator, ResourceGroupInfo* info)
@@ -314,33 +1212,60 @@ static ResourceGroupHnd CreateResourceGroup(Allocator* allocator, ResourceGroupI
     uint32 frame_count = GetFrameCount();
 
     res_group->max_buffers  = info->max_buffers;
-    res_group->buffer_count = 0;
+    res_group->buffer_count.store(0);
     if (res_group->max_buffers > 0)
     {
-        res_group->buffer_infos        = Allocate<BufferInfo>      (allocator, info->max_buffers);
-        res_group->buffer_states       = Allocate<BufferState>     (allocator, info->max_buffers);
-        res_group->buffer_frame_states = Allocate<BufferFrameState>(allocator, info->max_buffers * frame_count);
+        res_group->buffer_infos         = Allocate<BufferInfo>      (allocator, info->max_buffers);
+        res_group->buffer_states        = Allocate<BufferState>     (allocator, info->max_buffers);
+        res_group->buffer_frame_states  = Allocate<BufferFrameState>(allocator, info->max_buffers * frame_count);
+        res_group->buffer_suballocators = Allocate<Suballocator*>   (allocator, info->max_buffers);
+        res_group->free_buffer_indexes  = Allocate<uint32>          (allocator, info->max_buffers);
+        res_group->buffer_generations   = Allocate<std::atomic<uint32>>(allocator, info->max_buffers);
+        memset(res_group->buffer_suballocators, 0, info->max_buffers * sizeof(Suballocator*));
+        for (uint32 i = 0; i < info->max_buffers; ++i)
+        {
+            res_group->buffer_generations[i].store(0);
+        }
     }
+    res_group->free_buffer_count = 0;
 
     res_group->max_image_mems  = info->max_image_mems;
     res_group->image_mem_count = 0;
     if (res_group->max_image_mems > 0)
     {
-        res_group->image_mem_infos  = Allocate<ImageMemoryInfo> (allocator, info->max_image_mems);
-        res_group->image_mem_states = Allocate<ImageMemoryState>(allocator, info->max_image_mems);
+        res_group->image_mem_infos         = Allocate<ImageMemoryInfo> (allocator, info->max_image_mems);
+        res_group->image_mem_states        = Allocate<ImageMemoryState>(allocator, info->max_image_mems);
+        res_group->image_mem_suballocators = Allocate<Suballocator*>   (allocator, info->max_image_mems);
+        memset(res_group->image_mem_suballocators, 0, info->max_image_mems * sizeof(Suballocator*));
     }
 
     res_group->max_images  = info->max_images;
-    res_group->image_count = 0;
+    res_group->image_count.store(0);
     if (res_group->max_images > 0)
     {
         res_group->image_infos        = Allocate<ImageInfo>      (allocator, info->max_images);
         res_group->image_view_infos   = Allocate<ImageViewInfo>  (allocator, info->max_images);
         res_group->image_states       = Allocate<ImageState>     (allocator, info->max_images);
         res_group->image_frame_states = Allocate<ImageFrameState>(allocator, info->max_images * frame_count);
+        res_group->free_image_indexes = Allocate<uint32>         (allocator, info->max_images);
+        res_group->image_generations  = Allocate<std::atomic<uint32>>(allocator, info->max_images);
+        for (uint32 i = 0; i < info->max_images; ++i)
+        {
+            res_group->image_generations[i].store(0);
+        }
     }
+    res_group->free_image_count = 0;
+
+    res_group->max_pages = info->max_pages > 0 ? info->max_pages : DEFAULT_MAX_PAGES;
+    res_group->page_size = info->page_size > 0 ? info->page_size : DEFAULT_PAGE_SIZE;
+    res_group->pages     = Allocate<ResourceMemoryPage>(allocator, res_group->max_pages);
+    memset(res_group->pages, 0, res_group->max_pages * sizeof(ResourceMemoryPage));
+    ResetResourceMemoryPages(res_group);
 
     res_group->frame_count = frame_count;
+    res_group->allocator   = allocator;
+    res_group->lock        = Allocate<ResourceLock>(allocator, 1);
+    res_group->lock->locked.store(false);
 
     return hnd;
 }
@@ -379,50 +1304,55 @@ static void SetMinAlignmentIfRequested(BufferInfo* buffer_info, BufferState* buf
     }
 }
 
-static BufferHnd DefineBuffer(ResourceGroupHnd res_group_hnd, BufferInfo* buffer_info)
+// Resolves buffer_info's memory requirements and type, which needs no lock.
+static void GetBufferDefinition(BufferDefinition* definition, BufferInfo* buffer_info)
+{
+    // Resource memory buffers always expose device addresses (see GetBufferDeviceAddress()).
+    definition->usage = buffer_info->usage | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    GetBufferMemoryRequirements(&definition->mem_requirements, buffer_info->size, definition->usage);
+
+    // Small per-frame host buffers are rewritten every frame and read by the device every draw, so they go in device
+    // local host visible memory when available.
+    VkMemoryPropertyFlags preferred_properties = buffer_info->preferred_properties;
+    if (buffer_info->per_frame &&
+        buffer_info->size <= MAX_AUTO_DEVICE_LOCAL_HOST_SIZE &&
+        (buffer_info->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+    {
+        preferred_properties |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    }
+
+    definition->res_mem_index = GetCapableMemoryTypeIndex(&definition->mem_requirements, buffer_info->properties,
+                                                          preferred_properties);
+}
+
+// Reserves next buffer slot and grows resource memory for it. Caller must hold group's lock and have checked capacity.
+static BufferHnd DefineBufferLocked(ResourceGroupHnd res_group_hnd, BufferInfo* buffer_info,
+                                    BufferDefinition* definition)
 {
-    VkDevice device = GetDevice();
-    ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
-    VkResult res = VK_SUCCESS;
-
     ResourceGroup* res_group = GetResourceGroup(res_group_hnd.index);
-    if (res_group->buffer_count >= res_group->max_buffers)
-    {
-        CTK_FATAL("can't create buffer: already at max of %u buffers", res_group->max_buffers);
-    }
 
     // Create handle.
-    BufferHnd buffer_hnd = { .group_index = res_group_hnd.index, .index = res_group->buffer_count };
-    res_group->buffer_count += 1;
+    uint32 buffer_index = res_group->buffer_count.load(std::memory_order_relaxed);
+    BufferHnd buffer_hnd =
+    {
+        .group_index = res_group_hnd.index,
+        .index       = buffer_index,
+        .generation  = res_group->buffer_generations[buffer_index].load(std::memory_order_relaxed),
+    };
+    res_group->buffer_count.store(buffer_index + 1, std::memory_order_release);
 
     // Copy info.
     *GetBufferInfo(res_group, buffer_hnd.index) = *buffer_info;
 
-    // Create dummy buffer to get memory requirements.
-    VkBufferCreateInfo buffer_create_info = {};
-    buffer_create_info.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    buffer_create_info.pNext                 = NULL;
-    buffer_create_info.flags                 = 0;
-    buffer_create_info.size                  = buffer_info     ->size;
-    buffer_create_info.usage                 = buffer_info     ->usage;
-    buffer_create_info.sharingMode           = resource_sharing->mode;
-    buffer_create_info.queueFamilyIndexCount = resource_sharing->queue_family_index_count;
-    buffer_create_info.pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
-
-    VkBuffer temp = VK_NULL_HANDLE;
-    res = vkCreateBuffer(device, &buffer_create_info, NULL, &temp);
-    Validate(res, "vkCreateBuffer() failed");
-    VkMemoryRequirements mem_requirements = {};
-    vkGetBufferMemoryRequirements(device, temp, &mem_requirements);
-    vkDestroyBuffer(device, temp, NULL);
-
     // Initialize buffer state.
-    uint32 res_mem_index = GetCapableMemoryTypeIndex(&mem_requirements, buffer_info->properties);
-    ResourceMemory* res_mem = GetResourceMemory(res_group, res_mem_index);
+    ResourceMemory* res_mem = GetResourceMemory(res_group, definition->res_mem_index);
     BufferState* buffer_state = GetBufferState(res_group, buffer_hnd.index);
-    buffer_state->size          = mem_requirements.size;
+    buffer_state->size          = definition->mem_requirements.size;
     buffer_state->alignment     = buffer_info->alignment;
-    buffer_state->res_mem_index = res_mem_index;
+    buffer_state->res_mem_index = definition->res_mem_index;
+    buffer_state->parent_index  = UNSET_INDEX;
+    buffer_state->page_index    = UNSET_INDEX;
+    buffer_state->suballocator  = NULL;
     if (buffer_info->per_frame)
     {
         buffer_state->frame_stride = res_group->max_buffers;
@@ -436,7 +1366,7 @@ static BufferHnd DefineBuffer(ResourceGroupHnd res_group_hnd, BufferInfo* buffer
     SetMinAlignmentIfRequested(buffer_info, buffer_state);
 
     // Append usage for vulkan buffer creation during device memory allocation.
-    res_mem->buffer_usage |= buffer_info->usage;
+    res_mem->buffer_usage |= definition->usage;
 
     // Calculate buffer offsets for each frame and update device memory size.
     for (uint32 frame_index = 0; frame_index < buffer_state->frame_count; ++frame_index)
@@ -444,24 +1374,72 @@ static BufferHnd DefineBuffer(ResourceGroupHnd res_group_hnd, BufferInfo* buffer
         BufferFrameState* buffer_frame_state = GetBufferFrameState(res_group, buffer_hnd.index, frame_index);
         buffer_frame_state->res_mem_offset = Align(res_mem->size, buffer_state->alignment);
         buffer_frame_state->index          = 0;
+        buffer_frame_state->suballocation  = UNSET_INDEX;
         res_mem->size = buffer_frame_state->res_mem_offset + buffer_state->size;
     }
+    ResetBufferSuballocator(res_group, buffer_hnd.index);
+
+    return buffer_hnd;
+}
+
+static BufferHnd DefineBuffer(ResourceGroupHnd res_group_hnd, BufferInfo* buffer_info)
+{
+    ResourceGroup* res_group = GetResourceGroup(res_group_hnd.index);
+    BufferDefinition definition = {};
+    GetBufferDefinition(&definition, buffer_info);
+
+    LockResources(res_group->lock);
+    if (res_group->buffer_count.load(std::memory_order_relaxed) >= res_group->max_buffers)
+    {
+        CTK_FATAL("can't create buffer: already at max of %u buffers", res_group->max_buffers);
+    }
+    BufferHnd buffer_hnd = DefineBufferLocked(res_group_hnd, buffer_info, &definition);
+    UnlockResources(res_group->lock);
 
     return buffer_hnd;
 }
 
+// Defines buffer_count buffers at once, reserving all their slots under a single lock acquisition so concurrent
+// definitions can't make a batch fail partway. Memory requirements are cached by usage, so defining many buffers costs
+// next to no driver calls.
+static void DefineBuffers(ResourceGroupHnd res_group_hnd, BufferInfo* buffer_infos, uint32 buffer_count,
+                          BufferHnd* buffer_hnds)
+{
+    CTK::Frame frame = CreateFrame();
+    ResourceGroup* res_group = GetResourceGroup(res_group_hnd.index);
+    BufferDefinition* definitions = Allocate<BufferDefinition>(&frame, buffer_count);
+    for (uint32 i = 0; i < buffer_count; ++i)
+    {
+        GetBufferDefinition(&definitions[i], &buffer_infos[i]);
+    }
+
+    LockResources(res_group->lock);
+    if (res_group->buffer_count.load(std::memory_order_relaxed) + buffer_count > res_group->max_buffers)
+    {
+        CTK_FATAL("can't define %u buffers: would exceed max of %u buffers", buffer_count, res_group->max_buffers);
+    }
+    for (uint32 i = 0; i < buffer_count; ++i)
+    {
+        buffer_hnds[i] = DefineBufferLocked(res_group_hnd, &buffer_infos[i], &definitions[i]);
+    }
+    UnlockResources(res_group->lock);
+}
+
 static ImageMemoryHnd DefineImageMemory(ResourceGroupHnd res_group_hnd, ImageMemoryInfo* image_mem_info)
 {
     ResourceGroup* res_group = GetResourceGroup(res_group_hnd.index);
+
+    VkMemoryRequirements mem_requirements = {};
+    GetImageMemoryTypeRequirements(&mem_requirements, image_mem_info);
+    uint32 res_mem_index = GetCapableMemoryTypeIndex(&mem_requirements, image_mem_info->properties,
+                                                     image_mem_info->preferred_properties);
+
+    LockResources(res_group->lock);
     if (res_group->image_mem_count >= res_group->max_image_mems)
     {
         CTK_FATAL("can't create image memory: already at max of %u image memories", res_group->max_image_mems);
     }
 
-    VkDevice device = GetDevice();
-    ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
-    VkResult res = VK_SUCCESS;
-
     // Create handle.
     ImageMemoryHnd image_mem_hnd = { .group_index = res_group_hnd.index, .index = res_group->image_mem_count };
     res_group->image_mem_count += 1;
@@ -469,42 +1447,17 @@ static ImageMemoryHnd DefineImageMemory(ResourceGroupHnd res_group_hnd, ImageMem
     // Copy info.
     *GetImageMemoryInfo(res_group, image_mem_hnd.index) = *image_mem_info;
 
-    // Create dummy image to get memory requirements.
-    VkImageCreateInfo image_create_info = {};
-    image_create_info.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    image_create_info.pNext                 = NULL;
-    image_create_info.flags                 = image_mem_info  ->flags;
-    image_create_info.format                = image_mem_info  ->format;
-    image_create_info.tiling                = image_mem_info  ->tiling;
-    image_create_info.usage                 = image_mem_info  ->usage;
-    image_create_info.sharingMode           = resource_sharing->mode;
-    image_create_info.queueFamilyIndexCount = resource_sharing->queue_family_index_count;
-    image_create_info.pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
-    image_create_info.imageType             = VK_IMAGE_TYPE_1D;
-    image_create_info.extent                = { 1, 1, 1 };
-    image_create_info.mipLevels             = 1;
-    image_create_info.arrayLayers           = 1;
-    image_create_info.samples               = VK_SAMPLE_COUNT_1_BIT;
-    image_create_info.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
-
-    VkImage temp = VK_NULL_HANDLE;
-    res = vkCreateImage(device, &image_create_info, NULL, &temp);
-    Validate(res, "vkCreateImage() failed");
-    VkMemoryRequirements mem_requirements = {};
-    vkGetImageMemoryRequirements(device, temp, &mem_requirements);
-    vkDestroyImage(device, temp, NULL);
-
     // Initialize image memory state.
-    uint32 res_mem_index = GetCapableMemoryTypeIndex(&mem_requirements, image_mem_info->properties);
     ResourceMemory* res_mem = GetResourceMemory(res_group, res_mem_index);
     ImageMemoryState* image_mem_state = GetImageMemoryState(res_group, image_mem_hnd.index);
     image_mem_state->size           = image_mem_info->size;
-    image_mem_state->index          = 0;
     image_mem_state->res_mem_offset = res_mem->size;
     image_mem_state->res_mem_index  = res_mem_index;
+    ResetImageMemorySuballocator(res_group, image_mem_hnd.index);
 
     // Increase resource memory size by image memory size.
     res_mem->size += image_mem_info->size;
+    UnlockResources(res_group->lock);
 
     return image_mem_hnd;
 }
@@ -529,6 +1482,7 @@ static void AllocateResourceGroup(ResourceGroupHnd res_group_hnd)
 
         // Create buffer to be used by buffer resources suballocated from this device memory. This is done first to
         // get memory requirements in case required size is large than device memory size.
+        VkMemoryDedicatedAllocateInfo dedicated_info = {};
         if (res_mem->buffer_usage != 0)
         {
             VkBufferCreateInfo buffer_create_info = {};
@@ -544,11 +1498,27 @@ static void AllocateResourceGroup(ResourceGroupHnd res_group_hnd)
             res = vkCreateBuffer(device, &buffer_create_info, NULL, &res_mem->buffer);
             Validate(res, "vkCreateBuffer() failed");
             VkMemoryRequirements mem_requirements = {};
-            vkGetBufferMemoryRequirements(device, res_mem->buffer, &mem_requirements);
+            bool dedicated = QueryBufferMemoryRequirements(res_mem->buffer, &mem_requirements);
             res_mem->size = mem_requirements.size;
+
+            // Dedicated memory can only be bound to its buffer, so it's only used if no image memory shares it.
+            for (uint32 image_mem_index = 0; dedicated && image_mem_index < res_group->image_mem_count;
+                 ++image_mem_index)
+            {
+                dedicated = GetImageMemoryState(res_group, image_mem_index)->res_mem_index != res_mem_index;
+            }
+            if (dedicated)
+            {
+                dedicated_info.sType  = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+                dedicated_info.pNext  = NULL;
+                dedicated_info.image  = VK_NULL_HANDLE;
+                dedicated_info.buffer = res_mem->buffer;
+            }
         }
 
-        res_mem->hnd = AllocateDeviceMemory(res_mem_index, res_mem->size, NULL);
+        res_mem->hnd = AllocateDeviceMemory(res_mem_index, res_mem->size, NULL,
+                                            dedicated_info.buffer != VK_NULL_HANDLE ? &dedicated_info : NULL,
+                                            res_mem->buffer_usage != 0 ? VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT : 0);
 
         // Map host visible memory.
         if (res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
@@ -561,6 +1531,7 @@ static void AllocateResourceGroup(ResourceGroupHnd res_group_hnd)
         {
             res = vkBindBufferMemory(device, res_mem->buffer, res_mem->hnd, 0);
             Validate(res, "vkBindBufferMemory() failed");
+            res_mem->buffer_address = GetDeviceAddress(res_mem->buffer);
         }
     }
 }
@@ -568,11 +1539,7 @@ static void AllocateResourceGroup(ResourceGroupHnd res_group_hnd)
 static BufferHnd CreateBuffer(BufferHnd parent_buffer_hnd, BufferInfo* buffer_info)
 {
     ResourceGroup* res_group = GetResourceGroup(parent_buffer_hnd.group_index);
-    if (res_group->buffer_count >= res_group->max_buffers)
-    {
-        CTK_FATAL("can't create sub-buffer: already at max of %u buffers", res_group->max_buffers);
-    }
-
+    ValidateBuffer(res_group, parent_buffer_hnd, "can't create sub-buffer");
     BufferState* parent_buffer_state = GetBufferState(res_group, parent_buffer_hnd.index);
     if (parent_buffer_state->frame_count != 1)
     {
@@ -580,25 +1547,36 @@ static BufferHnd CreateBuffer(BufferHnd parent_buffer_hnd, BufferInfo* buffer_in
                   parent_buffer_state->frame_count);
     }
 
-    // Create handle.
-    BufferHnd buffer_hnd = { .group_index = parent_buffer_hnd.group_index, .index = res_group->buffer_count };
-    res_group->buffer_count += 1;
+    // Create handle, reusing slot of a destroyed buffer if available. Slot belongs to this thread once reserved.
+    LockResources(res_group->lock);
+    uint32 buffer_index = PopFreeIndex(res_group->free_buffer_indexes, &res_group->free_buffer_count,
+                                       &res_group->buffer_count, res_group->max_buffers, "buffer");
+    BufferHnd buffer_hnd =
+    {
+        .group_index = parent_buffer_hnd.group_index,
+        .index       = buffer_index,
+        .generation  = res_group->buffer_generations[buffer_index].load(std::memory_order_relaxed),
+    };
+    UnlockResources(res_group->lock);
 
     // Init buffer info.
     BufferInfo* parent_buffer_info = GetBufferInfo(res_group, parent_buffer_hnd.index);
     BufferInfo* stored_buffer_info = GetBufferInfo(res_group, buffer_hnd.index);
-    stored_buffer_info->size       = buffer_info       ->size;
-    stored_buffer_info->alignment  = buffer_info       ->alignment;
-    stored_buffer_info->per_frame  = buffer_info       ->per_frame;
-    stored_buffer_info->flags      = parent_buffer_info->flags;
-    stored_buffer_info->usage      = parent_buffer_info->usage;
-    stored_buffer_info->properties = parent_buffer_info->properties;
+    stored_buffer_info->size                 = buffer_info       ->size;
+    stored_buffer_info->alignment            = buffer_info       ->alignment;
+    stored_buffer_info->per_frame            = buffer_info       ->per_frame;
+    stored_buffer_info->flags                = parent_buffer_info->flags;
+    stored_buffer_info->usage                = parent_buffer_info->usage;
+    stored_buffer_info->properties           = parent_buffer_info->properties;
+    stored_buffer_info->preferred_properties = parent_buffer_info->preferred_properties;
 
     // Init buffer state.
     BufferState* buffer_state = GetBufferState(res_group, buffer_hnd.index);
     buffer_state->size          = buffer_info        ->size;
     buffer_state->alignment     = buffer_info        ->alignment;
     buffer_state->res_mem_index = parent_buffer_state->res_mem_index;
+    buffer_state->parent_index  = parent_buffer_hnd.index;
+    buffer_state->page_index    = parent_buffer_state->page_index;
     if (buffer_info->per_frame)
     {
         buffer_state->frame_stride = res_group->max_buffers;
@@ -611,56 +1589,70 @@ static BufferHnd CreateBuffer(BufferHnd parent_buffer_hnd, BufferInfo* buffer_in
     }
     SetMinAlignmentIfRequested(buffer_info, buffer_state);
 
+    // Suballocate each frame's range from parent buffer (offsets are relative to resource memory or page, so alignment
+    // is absolute). If parent buffer is full, grow into a page of the same memory type instead.
+    Suballocation suballocations[MAX_FRAME_COUNT] = {};
+    LockResources(res_group->lock);
+    buffer_state->suballocator = GetBufferSuballocator(res_group, parent_buffer_hnd.index);
+    if (!SuballocateFrames(suballocations, buffer_state->suballocator, buffer_state->frame_count, buffer_state->size,
+                           buffer_state->alignment))
+    {
+        buffer_state->page_index = SuballocatePageFrames(suballocations, res_group, buffer_state->res_mem_index,
+                                                         buffer_state->frame_count, buffer_state->size,
+                                                         buffer_state->alignment);
+        buffer_state->suballocator = GetResourceMemoryPage(res_group, buffer_state->page_index)->suballocator;
+    }
+    UnlockResources(res_group->lock);
+
     // Init buffer frame states.
-    BufferFrameState* parent_buffer_frame_state = GetBufferFrameState(res_group, parent_buffer_hnd.index, 0);
     for (uint32 frame_index = 0; frame_index < buffer_state->frame_count; frame_index += 1)
     {
-        VkDeviceSize res_mem_relative_index =
-            parent_buffer_frame_state->res_mem_offset + parent_buffer_frame_state->index;
-        VkDeviceSize aligned_index =
-            Align(res_mem_relative_index, buffer_state->alignment) - parent_buffer_frame_state->res_mem_offset;
-        if (aligned_index + buffer_state->size > parent_buffer_state->size)
-        {
-            CTK_FATAL("can't create sub-buffer frame %u from parent buffer at %u-byte aligned index %u: buffer size of "
-                      "%u would exceed parent buffer's size of %u",
-                      frame_index,
-                      buffer_state->alignment,
-                      aligned_index,
-                      buffer_state->size,
-                      parent_buffer_state->size);
-        }
         BufferFrameState* buffer_frame_state = GetBufferFrameState(res_group, buffer_hnd.index, frame_index);
-        buffer_frame_state->res_mem_offset = parent_buffer_frame_state->res_mem_offset + aligned_index;
+        buffer_frame_state->res_mem_offset = suballocations[frame_index].offset;
         buffer_frame_state->index          = 0;
-        parent_buffer_frame_state->index = aligned_index + buffer_state->size;
+        buffer_frame_state->suballocation  = suballocations[frame_index].block_index;
     }
+    ResetBufferSuballocator(res_group, buffer_hnd.index);
 
     return buffer_hnd;
 }
 
-static ImageHnd CreateImage(ImageMemoryHnd image_mem_hnd, ImageInfo* image_info, ImageViewInfo* image_view_info)
+static void ValidateImageMemory(ResourceGroup* res_group, ImageMemoryHnd image_mem_hnd, const char* action)
 {
-    ResourceGroup* res_group = GetResourceGroup(image_mem_hnd.group_index);
-    if (res_group->image_count >= res_group->max_images)
+    LockResources(res_group->lock);
+    uint32 image_mem_count = res_group->image_mem_count;
+    UnlockResources(res_group->lock);
+    if (image_mem_hnd.index >= image_mem_count)
     {
-        CTK_FATAL("can't create image: already at max of %u images", res_group->max_images);
+        CTK_FATAL("%s: image memory index %u exceeds image memory count of %u", action, image_mem_hnd.index,
+                  image_mem_count);
     }
-    if (image_mem_hnd.index >= res_group->image_mem_count)
+}
+
+// Reserves an image slot, reusing slot of a destroyed image if available. Caller must hold group's lock and have
+// checked capacity; slot belongs to calling thread once reserved.
+static ImageHnd ReserveImageLocked(ResourceGroup* res_group, ImageMemoryHnd image_mem_hnd)
+{
+    uint32 image_index = PopFreeIndex(res_group->free_image_indexes, &res_group->free_image_count,
+                                      &res_group->image_count, res_group->max_images, "image");
+    ImageHnd image_hnd =
     {
-        CTK_FATAL("can't create image: image memory index %u exceeds image memory count of %u",
-                  image_mem_hnd.index, res_group->image_mem_count);
-    }
+        .group_index = image_mem_hnd.group_index,
+        .index       = image_index,
+        .generation  = res_group->image_generations[image_index].load(std::memory_order_relaxed),
+    };
+    return image_hnd;
+}
 
+// Creates reserved image's frame images and views and binds them to memory.
+static void InitImage(ResourceGroup* res_group, ImageMemoryHnd image_mem_hnd, ImageHnd image_hnd,
+                      ImageInfo* image_info, ImageViewInfo* image_view_info)
+{
     ImageMemoryInfo* image_mem_info = GetImageMemoryInfo(res_group, image_mem_hnd.index);
 
     VkDevice device = GetDevice();
-    ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
     VkResult res = VK_SUCCESS;
 
-    // Create handle.
-    ImageHnd image_hnd = { .group_index = image_mem_hnd.group_index, .index = res_group->image_count };
-    res_group->image_count += 1;
-
     // Copy image/view info.
     *GetImageInfo    (res_group, image_hnd.index) = *image_info;
     *GetImageViewInfo(res_group, image_hnd.index) = *image_view_info;
@@ -674,50 +1666,75 @@ static ImageHnd CreateImage(ImageMemoryHnd image_mem_hnd, ImageInfo* image_info,
     }
 
     // Create images for each frame.
-    VkImageCreateInfo image_create_info = {};
-    image_create_info.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    image_create_info.pNext                 = NULL;
-    image_create_info.flags                 = image_mem_info  ->flags;
-    image_create_info.format                = image_mem_info  ->format;
-    image_create_info.tiling                = image_mem_info  ->tiling;
-    image_create_info.usage                 = image_mem_info  ->usage;
-    image_create_info.imageType             = image_info      ->type;
-    image_create_info.extent                = image_info      ->extent;
-    image_create_info.mipLevels             = image_info      ->mip_levels;
-    image_create_info.arrayLayers           = image_info      ->array_layers;
-    image_create_info.samples               = image_info      ->samples;
-    image_create_info.initialLayout         = image_info      ->initial_layout;
-    image_create_info.sharingMode           = resource_sharing->mode;
-    image_create_info.queueFamilyIndexCount = resource_sharing->queue_family_index_count;
-    image_create_info.pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
     for (uint32 frame_index = 0; frame_index < image_frame_count; ++frame_index)
     {
         ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_hnd.index, frame_index);
-        res = vkCreateImage(device, &image_create_info, NULL, &image_frame_state->image);
-        Validate(res, "vkCreateImage() failed");
+        image_frame_state->image = CreateFrameImage(image_mem_info, image_info);
     }
 
     // Init image state.
     VkMemoryRequirements mem_requirements = {};
-    vkGetImageMemoryRequirements(device, GetImageFrameState(res_group, image_hnd.index, 0)->image, &mem_requirements);
+    bool dedicated = QueryImageMemoryRequirements(GetImageFrameState(res_group, image_hnd.index, 0)->image,
+                                                  &mem_requirements);
     ImageState* image_state = GetImageState(res_group, image_hnd.index);
     image_state->size            = mem_requirements.size;
     image_state->alignment       = mem_requirements.alignment;
     image_state->image_mem_index = image_mem_hnd.index;
+    image_state->page_index      = UNSET_INDEX;
     image_state->frame_stride    = image_frame_stride;
     image_state->frame_count     = image_frame_count;
+    image_state->dedicated       = dedicated;
+
+    // Give each frame's image its own device memory if the driver prefers it, bypassing image memory entirely.
+    if (dedicated)
+    {
+        uint32 mem_type_index = GetCapableMemoryTypeIndex(&mem_requirements, image_mem_info->properties,
+                                                          image_mem_info->preferred_properties);
+        for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
+        {
+            ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_hnd.index, frame_index);
+            VkMemoryDedicatedAllocateInfo dedicated_info =
+            {
+                .sType  = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+                .pNext  = NULL,
+                .image  = image_frame_state->image,
+                .buffer = VK_NULL_HANDLE,
+            };
+            image_frame_state->dedicated_mem    = AllocateDeviceMemory(mem_type_index, mem_requirements.size, NULL,
+                                                                       &dedicated_info);
+            image_frame_state->image_mem_offset = 0;
+            image_frame_state->suballocation    = UNSET_INDEX;
+            res = vkBindImageMemory(device, image_frame_state->image, image_frame_state->dedicated_mem, 0);
+            Validate(res, "vkBindImageMemory() failed");
+            image_frame_state->view = CreateFrameImageView(image_frame_state->image, image_mem_info, image_view_info);
+        }
+        return;
+    }
 
-    // Calculate offset in image memory, update image memory index, then bind to image memory at offset for each frame.
+    // Suballocate each frame's range from image memory, growing into a page of the same memory type if image memory is
+    // full, then bind frame images to device memory at their range's offset.
     ImageMemoryState* image_mem_state = GetImageMemoryState(res_group, image_mem_hnd.index);
+    Suballocation suballocations[MAX_FRAME_COUNT] = {};
+    VkDeviceMemory device_mem = GetResourceMemory(res_group, image_mem_state->res_mem_index)->hnd;
+    VkDeviceSize image_mem_offset = image_mem_state->res_mem_offset;
+    LockResources(res_group->lock);
+    if (!SuballocateFrames(suballocations, GetImageMemorySuballocator(res_group, image_mem_hnd.index),
+                           image_state->frame_count, image_state->size, image_state->alignment))
+    {
+        image_state->page_index = SuballocatePageFrames(suballocations, res_group, image_mem_state->res_mem_index,
+                                                        image_state->frame_count, image_state->size,
+                                                        image_state->alignment);
+        device_mem       = GetResourceMemoryPage(res_group, image_state->page_index)->hnd;
+        image_mem_offset = 0;
+    }
+    UnlockResources(res_group->lock);
     for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
     {
         ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_hnd.index, frame_index);
-
-        image_frame_state->image_mem_offset = AllocateImageMemory(image_mem_state, image_state);
-
-        ResourceMemory* res_mem = GetResourceMemory(res_group, image_mem_state->res_mem_index);
-        uint32 res_mem_offset = image_mem_state->res_mem_offset + image_frame_state->image_mem_offset;
-        res = vkBindImageMemory(device, image_frame_state->image, res_mem->hnd, res_mem_offset);
+        image_frame_state->image_mem_offset = suballocations[frame_index].offset - image_mem_offset;
+        image_frame_state->suballocation    = suballocations[frame_index].block_index;
+        image_frame_state->dedicated_mem    = VK_NULL_HANDLE;
+        res = vkBindImageMemory(device, image_frame_state->image, device_mem, suballocations[frame_index].offset);
         Validate(res, "vkBindImageMemory() failed");
     }
 
@@ -725,56 +1742,292 @@ static ImageHnd CreateImage(ImageMemoryHnd image_mem_hnd, ImageInfo* image_info,
     for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
     {
         ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_hnd.index, frame_index);
-        VkImageViewCreateInfo view_create_info =
-        {
-            .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-            .pNext            = NULL,
-            .flags            = image_view_info  ->flags,
-            .image            = image_frame_state->image,
-            .viewType         = image_view_info  ->type,
-            .format           = image_mem_info   ->format,
-            .components       = image_view_info  ->components,
-            .subresourceRange = image_view_info  ->subresource_range,
-        };
-        res = vkCreateImageView(device, &view_create_info, NULL, &image_frame_state->view);
-        Validate(res, "vkCreateImageView() failed");
+        image_frame_state->view = CreateFrameImageView(image_frame_state->image, image_mem_info, image_view_info);
     }
+}
+
+static ImageHnd CreateImage(ImageMemoryHnd image_mem_hnd, ImageInfo* image_info, ImageViewInfo* image_view_info)
+{
+    ResourceGroup* res_group = GetResourceGroup(image_mem_hnd.group_index);
+    ValidateImageMemory(res_group, image_mem_hnd, "can't create image");
+
+    LockResources(res_group->lock);
+    ImageHnd image_hnd = ReserveImageLocked(res_group, image_mem_hnd);
+    UnlockResources(res_group->lock);
+    InitImage(res_group, image_mem_hnd, image_hnd, image_info, image_view_info);
 
     return image_hnd;
 }
 
-static VkDeviceSize GetImageSize(ImageInfo* image_info, ImageMemoryInfo* image_mem_info)
+// Creates image_count images in image memory at once, reserving all their slots under a single lock acquisition so
+// concurrent creation can't make a batch fail partway. Vulkan has no batched image creation, so each image still costs
+// a vkCreateImage() per frame.
+static void CreateImages(ImageMemoryHnd image_mem_hnd, ImageInfo* image_infos, ImageViewInfo* image_view_infos,
+                         uint32 image_count, ImageHnd* image_hnds)
 {
-    VkDevice device = GetDevice();
-    ResourceSharing* resource_sharing = &GetPhysicalDevice()->resource_sharing;
+    ResourceGroup* res_group = GetResourceGroup(image_mem_hnd.group_index);
+    ValidateImageMemory(res_group, image_mem_hnd, "can't create images");
+
+    LockResources(res_group->lock);
+    uint32 used_image_count = res_group->image_count.load(std::memory_order_relaxed) - res_group->free_image_count;
+    if (used_image_count + image_count > res_group->max_images)
+    {
+        CTK_FATAL("can't create %u images: would exceed max of %u images", image_count, res_group->max_images);
+    }
+    for (uint32 i = 0; i < image_count; ++i)
+    {
+        image_hnds[i] = ReserveImageLocked(res_group, image_mem_hnd);
+    }
+    UnlockResources(res_group->lock);
+
+    for (uint32 i = 0; i < image_count; ++i)
+    {
+        InitImage(res_group, image_mem_hnd, image_hnds[i], &image_infos[i], &image_view_infos[i]);
+    }
+}
 
+// Returns true if images created with info would get dedicated memory instead of being suballocated from image memory.
+static bool GetImageMemoryRequirements(VkMemoryRequirements* mem_requirements, ImageInfo* image_info,
+                                       ImageMemoryInfo* image_mem_info)
+{
     VkImageCreateInfo image_create_info = {};
-    image_create_info.sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    image_create_info.pNext                 = NULL;
-    image_create_info.flags                 = image_mem_info  ->flags;
-    image_create_info.format                = image_mem_info  ->format;
-    image_create_info.tiling                = image_mem_info  ->tiling;
-    image_create_info.usage                 = image_mem_info  ->usage;
-    image_create_info.imageType             = image_info      ->type;
-    image_create_info.extent                = image_info      ->extent;
-    image_create_info.mipLevels             = image_info      ->mip_levels;
-    image_create_info.arrayLayers           = image_info      ->array_layers;
-    image_create_info.samples               = image_info      ->samples;
-    image_create_info.initialLayout         = image_info      ->initial_layout;
-    image_create_info.sharingMode           = resource_sharing->mode;
-    image_create_info.queueFamilyIndexCount = resource_sharing->queue_family_index_count;
-    image_create_info.pQueueFamilyIndices   = resource_sharing->queue_family_indexes;
-
-    VkImage temp = VK_NULL_HANDLE;
-    VkResult res = vkCreateImage(device, &image_create_info, NULL, &temp);
-    Validate(res, "vkCreateImage() failed");
-    VkMemoryRequirements mem_requirements = {};
-    vkGetImageMemoryRequirements(device, temp, &mem_requirements);
-    vkDestroyImage(device, temp, NULL);
+    GetImageCreateInfo(&image_create_info, image_mem_info, image_info);
+    return QueryImageMemoryRequirements(&image_create_info, mem_requirements);
+}
 
+static VkDeviceSize GetImageSize(ImageInfo* image_info, ImageMemoryInfo* image_mem_info)
+{
+    VkMemoryRequirements mem_requirements = {};
+    GetImageMemoryRequirements(&mem_requirements, image_info, image_mem_info);
     return mem_requirements.size;
 }
 
+static void InitHeadlessSwapchainImages(Allocator* allocator)
+{
+    Swapchain* swapchain = GetSwapchain();
+    uint32 image_count = swapchain->images.count;
+
+    ResourceGroupInfo res_group_info =
+    {
+        .max_buffers    = 0,
+        .max_image_mems = 1,
+        .max_images     = image_count,
+    };
+    ResourceGroupHnd res_group = CreateResourceGroup(allocator, &res_group_info);
+
+    // Offscreen images stand in for swapchain images, so they're rendered to as color attachments and read back
+    // through transfers instead of being presented.
+    ImageInfo image_info =
+    {
+        .extent =
+        {
+            .width  = swapchain->surface_extent.width,
+            .height = swapchain->surface_extent.height,
+            .depth  = 1
+        },
+        .type           = VK_IMAGE_TYPE_2D,
+        .mip_levels     = 1,
+        .array_layers   = 1,
+        .samples        = VK_SAMPLE_COUNT_1_BIT,
+        .initial_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .per_frame      = false,
+    };
+    ImageMemoryInfo image_mem_info =
+    {
+        .size       = 0,
+        .flags      = 0,
+        .usage      = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        .properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .format     = swapchain->surface_format.format,
+        .tiling     = VK_IMAGE_TILING_OPTIMAL,
+    };
+    ImageViewInfo image_view_info =
+    {
+        .flags      = 0,
+        .type       = VK_IMAGE_VIEW_TYPE_2D,
+        .components =
+        {
+            .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+        },
+        .subresource_range =
+        {
+            .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel   = 0,
+            .levelCount     = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount     = VK_REMAINING_ARRAY_LAYERS,
+        },
+    };
+
+    // Size image memory to fit all images, including worst-case alignment padding before and between them, unless
+    // images get dedicated memory.
+    VkMemoryRequirements mem_requirements = {};
+    if (!GetImageMemoryRequirements(&mem_requirements, &image_info, &image_mem_info))
+    {
+        image_mem_info.size = (Align(mem_requirements.size, mem_requirements.alignment) * image_count) +
+                              mem_requirements.alignment;
+    }
+    ImageMemoryHnd image_mem = DefineImageMemory(res_group, &image_mem_info);
+
+    AllocateResourceGroup(res_group);
+
+    ResourceGroup* res_group_ptr = GetResourceGroup(res_group.index);
+    for (uint32 i = 0; i < image_count; ++i)
+    {
+        ImageHnd image = CreateImage(image_mem, &image_info, &image_view_info);
+        ImageFrameState* image_frame_state = GetImageFrameState(res_group_ptr, image.index, 0);
+        Set(&swapchain->images,      i, image_frame_state->image);
+        Set(&swapchain->image_views, i, image_frame_state->view);
+    }
+}
+
+// Flushes all host writes to non-coherent memory made since the last flush, batching them into as few
+// vkFlushMappedMemoryRanges() calls as possible. Called before commands are submitted (see SubmitRenderCommands()).
+static void FlushHostWrites()
+{
+    FArray<VkMappedMemoryRange, MAX_MAPPED_RANGE_BATCH> ranges = {};
+    CTK_ITER(res_group, &g_res_groups)
+    {
+        for (uint32 res_mem_index = 0; res_mem_index < VK_MAX_MEMORY_TYPES; ++res_mem_index)
+        {
+            ResourceMemory* res_mem = GetResourceMemory(res_group, res_mem_index);
+            PushDirtyRange(&ranges, res_mem->hnd, res_mem->size, &res_mem->dirty_range);
+        }
+        for (uint32 page_index = 0; page_index < res_group->page_count; ++page_index)
+        {
+            ResourceMemoryPage* page = GetResourceMemoryPage(res_group, page_index);
+            PushDirtyRange(&ranges, page->hnd, page->size, &page->dirty_range);
+        }
+    }
+    FlushMappedRanges(&ranges);
+}
+
+// Handle is invalidated immediately; slot is reused once in-flight frames are done with resource.
+static void DestroyBuffer(BufferHnd buffer_hnd)
+{
+    ResourceGroup* res_group = GetResourceGroup(buffer_hnd.group_index);
+    ValidateBuffer(res_group, buffer_hnd, "can't destroy buffer");
+    if (GetBufferState(res_group, buffer_hnd.index)->parent_index == UNSET_INDEX)
+    {
+        CTK_FATAL("can't destroy buffer %u: only sub-buffers created with CreateBuffer() can be destroyed; buffers "
+                  "defined with DefineBuffer() are freed with their resource group", buffer_hnd.index);
+    }
+
+    LockResources(res_group->lock);
+    std::atomic<uint32>* generation = &res_group->buffer_generations[buffer_hnd.index];
+    generation->store(generation->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    UnlockResources(res_group->lock);
+    PushPendingDestroy(PendingDestroyType::BUFFER, buffer_hnd.group_index, buffer_hnd.index);
+}
+
+static void DestroyImage(ImageHnd image_hnd)
+{
+    ResourceGroup* res_group = GetResourceGroup(image_hnd.group_index);
+    ValidateImage(res_group, image_hnd, "can't destroy image");
+
+    LockResources(res_group->lock);
+    std::atomic<uint32>* generation = &res_group->image_generations[image_hnd.index];
+    generation->store(generation->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    UnlockResources(res_group->lock);
+    PushPendingDestroy(PendingDestroyType::IMAGE, image_hnd.group_index, image_hnd.index);
+}
+
+// Bumps generation of every slot in use so handles from before the group was freed fail validation once it's reused.
+static void InvalidateResourceHandles(ResourceGroup* res_group)
+{
+    for (uint32 buffer_index = 0; buffer_index < res_group->buffer_count; ++buffer_index)
+    {
+        res_group->buffer_generations[buffer_index] += 1;
+    }
+    for (uint32 image_index = 0; image_index < res_group->image_count; ++image_index)
+    {
+        res_group->image_generations[image_index] += 1;
+    }
+}
+
+static void ReclaimBuffer(ResourceGroup* res_group, uint32 buffer_index)
+{
+    BufferState* buffer_state = GetBufferState(res_group, buffer_index);
+    for (uint32 frame_index = 0; frame_index < buffer_state->frame_count; ++frame_index)
+    {
+        BufferFrameState* buffer_frame_state = GetBufferFrameState(res_group, buffer_index, frame_index);
+        FreeSuballocation(buffer_state->suballocator, buffer_frame_state->suballocation);
+        buffer_frame_state->suballocation = UNSET_INDEX;
+    }
+
+    res_group->free_buffer_indexes[res_group->free_buffer_count] = buffer_index;
+    res_group->free_buffer_count += 1;
+}
+
+static void ReclaimImage(ResourceGroup* res_group, uint32 image_index)
+{
+    VkDevice device = GetDevice();
+    ImageState* image_state = GetImageState(res_group, image_index);
+    Suballocator* image_mem_suballocator = image_state->page_index != UNSET_INDEX
+                                           ? GetResourceMemoryPage(res_group, image_state->page_index)->suballocator
+                                           : GetImageMemorySuballocator(res_group, image_state->image_mem_index);
+    for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
+    {
+        ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_index, frame_index);
+        vkDestroyImageView(device, image_frame_state->view, NULL);
+        vkDestroyImage(device, image_frame_state->image, NULL);
+        if (image_state->dedicated)
+        {
+            vkFreeMemory(device, image_frame_state->dedicated_mem, NULL);
+        }
+        else
+        {
+            FreeSuballocation(image_mem_suballocator, image_frame_state->suballocation);
+        }
+        image_frame_state->view          = VK_NULL_HANDLE;
+        image_frame_state->image         = VK_NULL_HANDLE;
+        image_frame_state->suballocation = UNSET_INDEX;
+        image_frame_state->dedicated_mem = VK_NULL_HANDLE;
+    }
+
+    res_group->free_image_indexes[res_group->free_image_count] = image_index;
+    res_group->free_image_count += 1;
+}
+
+// Frees memory and slots of destroyed resources whose frames have completed. Called by AcquireSwapchainImage().
+static void ReclaimDestroyedResources()
+{
+    if (g_pending_destroys.count == 0)
+    {
+        return;
+    }
+
+    uint64 completed_frame_value = GetCompletedFrameValue();
+    uint32 remaining_count = 0;
+    for (uint32 i = 0; i < g_pending_destroys.count; ++i)
+    {
+        PendingDestroy* pending_destroy = GetPtr(&g_pending_destroys, i);
+        if (pending_destroy->frame_value > completed_frame_value)
+        {
+            Set(&g_pending_destroys, remaining_count, *pending_destroy);
+            ++remaining_count;
+            continue;
+        }
+
+        // Worker threads may be creating resources in the same group, which share its suballocators and free lists.
+        ResourceGroup* res_group = GetResourceGroup(pending_destroy->group_index);
+        LockResources(res_group->lock);
+        if (pending_destroy->type == PendingDestroyType::BUFFER)
+        {
+            ReclaimBuffer(res_group, pending_destroy->index);
+        }
+        else
+        {
+            ReclaimImage(res_group, pending_destroy->index);
+        }
+        UnlockResources(res_group->lock);
+    }
+    g_pending_destroys.count = remaining_count;
+}
+
 static void DeallocateResourceGroup(ResourceGroupHnd res_group_hnd)
 {
     VkDevice device = GetDevice();
@@ -788,6 +2041,7 @@ static void DeallocateResourceGroup(ResourceGroupHnd res_group_hnd)
             ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_index, frame_index);
             vkDestroyImageView(device, image_frame_state->view, NULL);
             vkDestroyImage(device, image_frame_state->image, NULL);
+            vkFreeMemory(device, image_frame_state->dedicated_mem, NULL);
         }
     }
 
@@ -809,13 +2063,104 @@ static void DeallocateResourceGroup(ResourceGroupHnd res_group_hnd)
         }
     }
 
+    // Free resource memory pages.
+    for (uint32 page_index = 0; page_index < res_group->page_count; ++page_index)
+    {
+        ResourceMemoryPage* page = GetResourceMemoryPage(res_group, page_index);
+        if (page->mapped != NULL)
+        {
+            vkUnmapMemory(device, page->hnd);
+        }
+        vkFreeMemory(device, page->hnd, NULL);
+
+        if (page->buffer != VK_NULL_HANDLE)
+        {
+            vkDestroyBuffer(device, page->buffer, NULL);
+        }
+    }
+    ResetResourceMemoryPages(res_group);
+
     // Zero resource memory so sizes are set to 0 to prevent usage of freed resource memory.
     memset(res_group->res_mems, 0, VK_MAX_MEMORY_TYPES * sizeof(ResourceMemory));
 
     // Clear resource group.
-    res_group->buffer_count    = 0;
-    res_group->image_mem_count = 0;
-    res_group->image_count     = 0;
+    InvalidateResourceHandles(res_group);
+    res_group->buffer_count      = 0;
+    res_group->image_mem_count   = 0;
+    res_group->image_count       = 0;
+    res_group->free_buffer_count = 0;
+    res_group->free_image_count  = 0;
+    DropPendingDestroys(res_group_hnd.index);
+    DropDefragmenterMoves(res_group_hnd.index, true);
+}
+
+static void RetireResourceGroup(ResourceGroupHnd res_group_hnd)
+{
+    VkDevice device = GetDevice();
+    ResourceGroup* res_group = GetResourceGroup(res_group_hnd.index);
+
+    // Retire images and views so in-flight frames can finish using them.
+    for (uint32 image_index = 0; image_index < res_group->image_count; ++image_index)
+    {
+        for (uint32 frame_index = 0; frame_index < GetImageState(res_group, image_index)->frame_count; ++frame_index)
+        {
+            ImageFrameState* image_frame_state = GetImageFrameState(res_group, image_index, frame_index);
+            if (image_frame_state->image == VK_NULL_HANDLE) { continue; } // Destroyed and already reclaimed.
+
+            Retire(RetiredType::IMAGE_VIEW, (uint64)image_frame_state->view);
+            Retire(RetiredType::IMAGE, (uint64)image_frame_state->image);
+            if (image_frame_state->dedicated_mem != VK_NULL_HANDLE)
+            {
+                Retire(RetiredType::MEMORY, (uint64)image_frame_state->dedicated_mem);
+            }
+        }
+    }
+
+    // Retire resource memory. Unmapping doesn't affect device access, so memory is unmapped immediately.
+    for (uint32 mem_index = 0; mem_index < VK_MAX_MEMORY_TYPES; ++mem_index)
+    {
+        ResourceMemory* res_mem = GetResourceMemory(res_group, mem_index);
+        if (res_mem->size == 0) { continue; }
+
+        if (res_mem->properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            vkUnmapMemory(device, res_mem->hnd);
+        }
+        if (res_mem->buffer_usage != 0)
+        {
+            Retire(RetiredType::BUFFER, (uint64)res_mem->buffer);
+        }
+        Retire(RetiredType::MEMORY, (uint64)res_mem->hnd);
+    }
+
+    // Retire resource memory pages.
+    for (uint32 page_index = 0; page_index < res_group->page_count; ++page_index)
+    {
+        ResourceMemoryPage* page = GetResourceMemoryPage(res_group, page_index);
+        if (page->mapped != NULL)
+        {
+            vkUnmapMemory(device, page->hnd);
+        }
+        if (page->buffer != VK_NULL_HANDLE)
+        {
+            Retire(RetiredType::BUFFER, (uint64)page->buffer);
+        }
+        Retire(RetiredType::MEMORY, (uint64)page->hnd);
+    }
+    ResetResourceMemoryPages(res_group);
+
+    // Zero resource memory so sizes are set to 0 to prevent usage of retired resource memory.
+    memset(res_group->res_mems, 0, VK_MAX_MEMORY_TYPES * sizeof(ResourceMemory));
+
+    // Clear resource group so it can be reallocated immediately.
+    InvalidateResourceHandles(res_group);
+    res_group->buffer_count      = 0;
+    res_group->image_mem_count   = 0;
+    res_group->image_count       = 0;
+    res_group->free_buffer_count = 0;
+    res_group->free_image_count  = 0;
+    DropPendingDestroys(res_group_hnd.index);
+    DropDefragmenterMoves(res_group_hnd.index, false);
 }
 
 /// Debug
@@ -841,6 +2186,7 @@ static void LogResourceGroups(uint32 start = 0)
             PrintLine("                size:          %llu", state->size);
             PrintLine("                alignment:     %llu", state->alignment);
             PrintLine("                res_mem_index: %u",   state->res_mem_index);
+            PrintLine("                page_index:    %d",   (sint32)state->page_index);
             PrintLine("                frame_stride:  %u",   state->frame_stride);
             PrintLine("                frame_count:   %u",   state->frame_count);
             PrintLine("            frame_states:");
@@ -909,8 +2255,10 @@ static void LogResourceGroups(uint32 start = 0)
             PrintLine("                size:            %llu", state->size);
             PrintLine("                alignment:       %llu", state->alignment);
             PrintLine("                image_mem_index: %u",   state->image_mem_index);
+            PrintLine("                page_index:      %d",   (sint32)state->page_index);
             PrintLine("                frame_stride:    %u",   state->frame_stride);
             PrintLine("                frame_count:     %u",   state->frame_count);
+            PrintLine("                dedicated:       %s",   state->dedicated ? "true" : "false");
             PrintLine("            frame_states:");
             for (uint32 frame_index = 0; frame_index < state->frame_count; ++frame_index)
             {
@@ -940,7 +2288,11 @@ static void LogResourceGroups(uint32 start = 0)
             PrintLine("                tiling: %s", VkImageTilingName(image_mem_info->tiling));
             PrintLine("            state:");
             PrintLine("                size:           %llu", image_mem_state->size);
-            PrintLine("                index:          %llu", image_mem_state->index);
+            if (res_group->image_mem_suballocators[image_mem_index] != NULL)
+            {
+                PrintLine("                used:           %llu",
+                          res_group->image_mem_suballocators[image_mem_index]->used);
+            }
             PrintLine("                res_mem_offset: %llu", image_mem_state->res_mem_offset);
             PrintLine("                res_mem_index:  %u",   image_mem_state->res_mem_index);
         }
@@ -961,6 +2313,17 @@ static void LogResourceGroups(uint32 start = 0)
             PrintLine("            properties: ");
             PrintMemoryPropertyFlags(res_mem->properties, 4);
         }
+        for (uint32 page_index = 0; page_index < res_group->page_count; ++page_index)
+        {
+            ResourceMemoryPage* page = GetResourceMemoryPage(res_group, page_index);
+            PrintLine("        resource memory page %u:", page_index);
+            PrintLine("            size:          %llu", page->size);
+            PrintLine("            used:          %llu", page->suballocator->used);
+            PrintLine("            res_mem_index: %u",   page->res_mem_index);
+            PrintLine("            hnd:           0x%p", page->hnd);
+            PrintLine("            mapped:        0x%p", page->mapped);
+            PrintLine("            buffer:        0x%p", page->buffer);
+        }
 
         PrintLine();
     }
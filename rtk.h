@@ -1,10 +1,22 @@
 #pragma once
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
+#include <atomic>
 
+#ifdef _WIN32
 #define VK_USE_PLATFORM_WIN32_KHR
+#endif
 #include "vulkan/vulkan.h"
 
+// Mapped buffer writes use SSE2 non-temporal stores where available (always on x64).
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define RTK_STREAMING_STORES
+#include <emmintrin.h>
+#endif
+
 // Disable warnings when including stb_image.h.
 #pragma warning(push, 0)
 #define STB_IMAGE_IMPLEMENTATION
@@ -19,15 +31,21 @@ namespace RTK
 
 // Utils
 #include "rtk/debug.h"
+#include "rtk/cpu_tracer.h"
 #include "rtk/vk_array.h"
+#include "rtk/stream_copy.h"
 #include "rtk/device_features.h"
 
 // Context
 #include "rtk/context.h"
 
 // Resources
+#include "rtk/suballocator.h"
 #include "rtk/resource.h"
 #include "rtk/buffer.h"
+#include "rtk/transient.h"
+#include "rtk/upload.h"
+#include "rtk/staging.h"
 #include "rtk/image.h"
 
 // Assets
@@ -38,6 +56,9 @@ namespace RTK
 #include "rtk/pipeline.h"
 
 // Misc.
+#include "rtk/defragmenter.h"
+#include "rtk/gpu_profiler.h"
+#include "rtk/readback.h"
 #include "rtk/rendering.h"
 #include "rtk/frame_metrics.h"
 
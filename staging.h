@@ -0,0 +1,257 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr VkDeviceSize STAGING_ALIGNMENT      = 16;        // Satisfies buffer-image copy offset requirements.
+static constexpr VkDeviceSize STAGING_MIN_CHUNK_SIZE = 64 * 1024; // Smallest chunk worth waiting for.
+static constexpr uint32 DEFAULT_MAX_STAGING_REGIONS  = 256;
+
+struct StagingRingInfo
+{
+    BufferHnd buffer;      // Host visible buffer staging data is written to; its size is the staging window.
+    uint32    max_regions; // Uses DEFAULT_MAX_STAGING_REGIONS if 0.
+};
+
+// Range of ring read by an upload; freed by advancing ring's tail to end once upload completes.
+struct StagingRegion
+{
+    VkDeviceSize end;
+    UploadTicket ticket;
+};
+
+struct StagedBufferWrite
+{
+    VkDeviceSize size;
+    uint8*       src_data;
+    BufferHnd    dst_hnd;
+    VkDeviceSize dst_offset;
+};
+
+// Head and tail are offsets into an unbounded stream of staged bytes; ring offsets are taken modulo size, so a full
+// ring (head - tail == size) can be told apart from an empty one (head == tail).
+struct StagingRing
+{
+    bool           enabled;
+    BufferHnd      buffer;
+    VkDeviceSize   size;
+    VkDeviceSize   head;
+    VkDeviceSize   tail;
+
+    // FIFO of regions still being read, oldest first. Consecutive claims by the same upload share a region.
+    StagingRegion* regions; // size: max_regions
+    uint32         max_regions;
+    uint32         first_region;
+    uint32         region_count;
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static StagingRing g_staging;
+
+/// Utils
+////////////////////////////////////////////////////////////
+static StagingRegion* GetStagingRegion(uint32 i)
+{
+    CTK_ASSERT(i < g_staging.region_count);
+    return &g_staging.regions[(g_staging.first_region + i) % g_staging.max_regions];
+}
+
+static void PopStagingRegion()
+{
+    g_staging.tail = GetStagingRegion(0)->end;
+    g_staging.first_region = (g_staging.first_region + 1) % g_staging.max_regions;
+    g_staging.region_count -= 1;
+}
+
+static void ReclaimCompletedStagingRegions()
+{
+    while (g_staging.region_count > 0 && UploadComplete(GetStagingRegion(0)->ticket))
+    {
+        PopStagingRegion();
+    }
+}
+
+// Blocks until the oldest region is free, submitting the current upload first if it's the one reading it.
+static void WaitOldestStagingRegion()
+{
+    CTK_ASSERT(g_staging.region_count > 0);
+    StagingRegion* oldest = GetStagingRegion(0);
+    if (oldest->ticket.value == GetCurrentUpload()->ticket.value)
+    {
+        SplitUpload();
+    }
+    WaitUpload(oldest->ticket);
+    PopStagingRegion();
+}
+
+static void PushStagingRegion(VkDeviceSize end)
+{
+    UploadTicket ticket = GetCurrentUpload()->ticket;
+    if (g_staging.region_count > 0)
+    {
+        StagingRegion* newest = GetStagingRegion(g_staging.region_count - 1);
+        if (newest->ticket.value == ticket.value)
+        {
+            newest->end = end;
+            return;
+        }
+    }
+
+    if (g_staging.region_count == g_staging.max_regions)
+    {
+        WaitOldestStagingRegion();
+        ticket = GetCurrentUpload()->ticket; // Waiting may have split the current upload.
+    }
+    g_staging.regions[(g_staging.first_region + g_staging.region_count) % g_staging.max_regions] =
+    {
+        .end    = end,
+        .ticket = ticket,
+    };
+    g_staging.region_count += 1;
+}
+
+// Claims the largest contiguous range of at least min_size and at most max_size bytes, wrapping to the start of the
+// ring if the end doesn't have room. Blocks only while less than min_size bytes are free. Returns ring offset.
+static VkDeviceSize ClaimStaging(VkDeviceSize min_size, VkDeviceSize max_size, VkDeviceSize* claimed_size)
+{
+    CTK_ASSERT(min_size <= max_size);
+    CTK_ASSERT(min_size <= g_staging.size / 2);
+
+    ReclaimCompletedStagingRegions();
+    for (;;)
+    {
+        VkDeviceSize start       = Align(g_staging.head, STAGING_ALIGNMENT);
+        VkDeviceSize used_size   = start - g_staging.tail;
+        VkDeviceSize free_size   = used_size < g_staging.size ? g_staging.size - used_size : 0;
+        VkDeviceSize ring_offset = start % g_staging.size;
+        VkDeviceSize end_size    = g_staging.size - ring_offset; // Bytes between head and the end of the ring.
+
+        // Claim range at head if there's room before the end of the ring, otherwise skip to the start of the ring.
+        // Skipped bytes belong to the claimed region, so they're freed along with it.
+        VkDeviceSize size = Min(free_size, end_size);
+        if (size < min_size && free_size > end_size)
+        {
+            start      += end_size;
+            ring_offset = 0;
+            size        = free_size - end_size;
+        }
+        if (size >= min_size)
+        {
+            *claimed_size  = Min(size, max_size);
+            g_staging.head = start + *claimed_size;
+            PushStagingRegion(g_staging.head);
+            return ring_offset;
+        }
+
+        WaitOldestStagingRegion();
+    }
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitStagingRing(Allocator* allocator, StagingRingInfo* info)
+{
+    ResourceGroup* res_group = GetResourceGroup(info->buffer.group_index);
+    ValidateBuffer(res_group, info->buffer, "can't init staging ring");
+    BufferState* buffer_state = GetBufferState(res_group, info->buffer.index);
+    if (buffer_state->frame_count != 1)
+    {
+        CTK_FATAL("can't init staging ring: buffer must not be per-frame");
+    }
+    if ((GetResourceMemory(res_group, buffer_state->res_mem_index)->properties &
+         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0)
+    {
+        CTK_FATAL("can't init staging ring: buffer must be host visible");
+    }
+
+    // Ring offsets are kept aligned by keeping ring size a multiple of the alignment.
+    VkDeviceSize size = GetBufferInfo(res_group, info->buffer.index)->size / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    if (size < STAGING_MIN_CHUNK_SIZE * 2)
+    {
+        CTK_FATAL("can't init staging ring: buffer size of %u is less than minimum of %u", size,
+                  STAGING_MIN_CHUNK_SIZE * 2);
+    }
+
+    g_staging.enabled      = true;
+    g_staging.buffer       = info->buffer;
+    g_staging.size         = size;
+    g_staging.head         = 0;
+    g_staging.tail         = 0;
+    g_staging.max_regions  = info->max_regions > 0 ? info->max_regions : DEFAULT_MAX_STAGING_REGIONS;
+    g_staging.regions      = Allocate<StagingRegion>(allocator, g_staging.max_regions);
+    g_staging.first_region = 0;
+    g_staging.region_count = 0;
+}
+
+// Largest asset that can be staged in one piece, e.g. by StageImageUploadCmd().
+static VkDeviceSize GetMaxStagingSize()
+{
+    return g_staging.size / 2;
+}
+
+// Claims size bytes of the staging ring for the current upload and copies data into it, returning the ring offset
+// data was written at. Must be recorded into an upload (see BeginUpload()).
+static VkDeviceSize StageData(uint8* data, VkDeviceSize size)
+{
+    CTK_ASSERT(g_staging.enabled);
+    if (size > GetMaxStagingSize())
+    {
+        CTK_FATAL("can't stage %u bytes: exceeds max of %u bytes that can be staged in one piece", size,
+                  GetMaxStagingSize());
+    }
+
+    VkDeviceSize claimed_size = 0;
+    VkDeviceSize ring_offset = ClaimStaging(size, size, &claimed_size);
+    HostBufferWrite write =
+    {
+        .size       = size,
+        .src_data   = data,
+        .src_offset = 0,
+        .dst_hnd    = g_staging.buffer,
+        .dst_offset = ring_offset,
+    };
+    WriteHostBuffer(&write, 0);
+
+    return ring_offset;
+}
+
+// Streams write through the staging ring in chunks, so writes of any size can be uploaded through a small staging
+// window. If the ring fills, the current upload is submitted and recording continues in the next one, so the ticket
+// returned by SubmitUpload() covers all chunks.
+static void StageBufferUploadCmd(StagedBufferWrite* write, uint32 frame_index)
+{
+    CTK_ASSERT(g_staging.enabled);
+
+    VkDeviceSize uploaded_size = 0;
+    while (uploaded_size < write->size)
+    {
+        VkDeviceSize remaining_size = write->size - uploaded_size;
+        VkDeviceSize chunk_size = 0;
+        VkDeviceSize ring_offset = ClaimStaging(Min(remaining_size, STAGING_MIN_CHUNK_SIZE),
+                                                Min(remaining_size, GetMaxStagingSize()), &chunk_size);
+        HostBufferWrite host_write =
+        {
+            .size       = chunk_size,
+            .src_data   = write->src_data,
+            .src_offset = uploaded_size,
+            .dst_hnd    = g_staging.buffer,
+            .dst_offset = ring_offset,
+        };
+        WriteHostBuffer(&host_write, 0);
+
+        DeviceBufferWrite device_write =
+        {
+            .size       = chunk_size,
+            .src_hnd    = g_staging.buffer,
+            .src_offset = ring_offset,
+            .dst_hnd    = write->dst_hnd,
+            .dst_offset = write->dst_offset + uploaded_size,
+        };
+        UploadBufferCmd(&device_write, frame_index);
+        uploaded_size += chunk_size;
+    }
+}
+
+static BufferHnd GetStagingBuffer()
+{
+    CTK_ASSERT(g_staging.enabled);
+    return g_staging.buffer;
+}
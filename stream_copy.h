@@ -0,0 +1,135 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint64 CACHE_LINE_SIZE      = 64;
+static constexpr uint64 MIN_STREAM_COPY_SIZE = 256; // Smaller copies aren't worth the alignment and fence overhead.
+
+// Buffers sequential writes to a destination in a cache line, writing only whole aligned lines to the destination so
+// write-combined memory (e.g. HOST_VISIBLE memory without HOST_CACHED) never sees partial line writes.
+struct alignas(CACHE_LINE_SIZE) StreamWriter
+{
+    uint8  line[CACHE_LINE_SIZE];
+    uint8* dst;       // Start of line being buffered, or next byte to write if line_size is 0.
+    uint64 line_size; // Bytes buffered in line.
+};
+
+/// Utils
+////////////////////////////////////////////////////////////
+static bool IsCacheLineAligned(const void* ptr)
+{
+    return ((uintptr_t)ptr & (CACHE_LINE_SIZE - 1)) == 0;
+}
+
+// Writes a cache line to aligned dst with non-temporal stores, bypassing the cache.
+static void StreamCacheLine(uint8* dst, const uint8* src)
+{
+#ifdef RTK_STREAMING_STORES
+    __m128i a = _mm_loadu_si128((const __m128i*)(src +  0));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+    __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+    _mm_stream_si128((__m128i*)(dst +  0), a);
+    _mm_stream_si128((__m128i*)(dst + 16), b);
+    _mm_stream_si128((__m128i*)(dst + 32), c);
+    _mm_stream_si128((__m128i*)(dst + 48), d);
+#else
+    memcpy(dst, src, CACHE_LINE_SIZE);
+#endif
+}
+
+// Orders streamed stores before any later stores, e.g. the queue submission that makes the device read them.
+static void FenceStreamedStores()
+{
+#ifdef RTK_STREAMING_STORES
+    _mm_sfence();
+#endif
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+// memcpy() for destinations in write-combined memory: whole cache lines are written with non-temporal stores, so
+// copies don't read destination lines into the cache or evict the caller's working set. Unaligned head and tail bytes
+// are copied normally.
+static void StreamCopy(void* dst, const void* src, uint64 size)
+{
+    if (size < MIN_STREAM_COPY_SIZE)
+    {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    auto dst_bytes = (uint8*)dst;
+    auto src_bytes = (const uint8*)src;
+    uint64 head_size = (CACHE_LINE_SIZE - ((uintptr_t)dst_bytes & (CACHE_LINE_SIZE - 1))) & (CACHE_LINE_SIZE - 1);
+    memcpy(dst_bytes, src_bytes, head_size);
+    dst_bytes += head_size;
+    src_bytes += head_size;
+    size      -= head_size;
+
+    for (; size >= CACHE_LINE_SIZE; size -= CACHE_LINE_SIZE)
+    {
+        StreamCacheLine(dst_bytes, src_bytes);
+        dst_bytes += CACHE_LINE_SIZE;
+        src_bytes += CACHE_LINE_SIZE;
+    }
+    memcpy(dst_bytes, src_bytes, size);
+    FenceStreamedStores();
+}
+
+static void BeginStreamWrite(StreamWriter* writer, void* dst)
+{
+    writer->dst       = (uint8*)dst;
+    writer->line_size = 0;
+}
+
+// Appends size bytes to writer's destination. Bytes before the destination's first line boundary are written
+// directly; after that only whole lines are written, each with a single streamed line write.
+static void StreamWrite(StreamWriter* writer, const void* src, uint64 size)
+{
+    auto src_bytes = (const uint8*)src;
+    while (size > 0)
+    {
+        // Nothing buffered: write unaligned head directly, and stream whole lines straight from src.
+        if (writer->line_size == 0)
+        {
+            if (!IsCacheLineAligned(writer->dst))
+            {
+                uint64 head_size = Min(size, CACHE_LINE_SIZE - ((uintptr_t)writer->dst & (CACHE_LINE_SIZE - 1)));
+                memcpy(writer->dst, src_bytes, head_size);
+                writer->dst += head_size;
+                src_bytes   += head_size;
+                size        -= head_size;
+                continue;
+            }
+            if (size >= CACHE_LINE_SIZE)
+            {
+                StreamCacheLine(writer->dst, src_bytes);
+                writer->dst += CACHE_LINE_SIZE;
+                src_bytes   += CACHE_LINE_SIZE;
+                size        -= CACHE_LINE_SIZE;
+                continue;
+            }
+        }
+
+        // Buffer partial line until it's full.
+        uint64 copy_size = Min(size, CACHE_LINE_SIZE - writer->line_size);
+        memcpy(&writer->line[writer->line_size], src_bytes, copy_size);
+        writer->line_size += copy_size;
+        src_bytes         += copy_size;
+        size              -= copy_size;
+        if (writer->line_size == CACHE_LINE_SIZE)
+        {
+            StreamCacheLine(writer->dst, writer->line);
+            writer->dst      += CACHE_LINE_SIZE;
+            writer->line_size = 0;
+        }
+    }
+}
+
+// Writes any buffered partial line and fences streamed stores. Must be called before the device reads the writes.
+static void EndStreamWrite(StreamWriter* writer)
+{
+    memcpy(writer->dst, writer->line, writer->line_size);
+    writer->dst      += writer->line_size;
+    writer->line_size = 0;
+    FenceStreamedStores();
+}
@@ -0,0 +1,351 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint32 SUBALLOCATOR_SL_BITS    = 4;
+static constexpr uint32 SUBALLOCATOR_SL_COUNT   = 1 << SUBALLOCATOR_SL_BITS;
+static constexpr uint32 SUBALLOCATOR_FL_COUNT   = 64;
+static constexpr uint64 SUBALLOCATOR_SMALL_SIZE = SUBALLOCATOR_SL_COUNT; // Smaller sizes map linearly into FL 0.
+
+struct SuballocatorBlock
+{
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    uint32       prev_phys; // Neighbouring blocks by offset.
+    uint32       next_phys;
+    uint32       prev_free; // Neighbouring blocks in size class free list; next_free also links unused blocks.
+    uint32       next_free;
+    bool         free;
+};
+
+// Two-level segregated fit (TLSF) allocator over a range of offsets with O(1) allocation and free. Block metadata is
+// stored separately from the range it describes, so it can be used to suballocate device memory.
+struct Suballocator
+{
+    VkDeviceSize       base_offset;
+    VkDeviceSize       size;
+    VkDeviceSize       used;
+    SuballocatorBlock* blocks; // size: max_blocks
+    uint32             max_blocks;
+    uint32             unused_block_head;
+    uint32             allocation_count;
+    uint64             fl_bitmap;
+    uint32             sl_bitmaps[SUBALLOCATOR_FL_COUNT];
+    uint32             free_heads[SUBALLOCATOR_FL_COUNT][SUBALLOCATOR_SL_COUNT];
+};
+
+struct Suballocation
+{
+    VkDeviceSize offset;
+    uint32       block_index;
+};
+
+/// Utils
+////////////////////////////////////////////////////////////
+static uint32 FindHighestSetBit(uint64 bits)
+{
+    CTK_ASSERT(bits != 0);
+#ifdef _WIN32
+    unsigned long index = 0;
+    _BitScanReverse64(&index, bits);
+    return (uint32)index;
+#else
+    return 63u - (uint32)__builtin_clzll(bits);
+#endif
+}
+
+static uint32 FindLowestSetBit(uint64 bits)
+{
+    CTK_ASSERT(bits != 0);
+#ifdef _WIN32
+    unsigned long index = 0;
+    _BitScanForward64(&index, bits);
+    return (uint32)index;
+#else
+    return (uint32)__builtin_ctzll(bits);
+#endif
+}
+
+static void GetSizeClass(VkDeviceSize size, uint32* fl, uint32* sl)
+{
+    if (size < SUBALLOCATOR_SMALL_SIZE)
+    {
+        *fl = 0;
+        *sl = (uint32)size;
+        return;
+    }
+
+    uint32 log2 = FindHighestSetBit(size);
+    *fl = log2 - SUBALLOCATOR_SL_BITS + 1;
+    *sl = (uint32)(size >> (log2 - SUBALLOCATOR_SL_BITS)) - SUBALLOCATOR_SL_COUNT;
+}
+
+static SuballocatorBlock* GetBlock(Suballocator* suballocator, uint32 block_index)
+{
+    CTK_ASSERT(block_index < suballocator->max_blocks);
+    return &suballocator->blocks[block_index];
+}
+
+static uint32 AcquireBlock(Suballocator* suballocator)
+{
+    uint32 block_index = suballocator->unused_block_head;
+    if (block_index == UNSET_INDEX)
+    {
+        CTK_FATAL("can't acquire suballocator block: all %u blocks are in use", suballocator->max_blocks);
+    }
+
+    suballocator->unused_block_head = GetBlock(suballocator, block_index)->next_free;
+    return block_index;
+}
+
+static void ReleaseBlock(Suballocator* suballocator, uint32 block_index)
+{
+    GetBlock(suballocator, block_index)->next_free = suballocator->unused_block_head;
+    suballocator->unused_block_head = block_index;
+}
+
+static void InsertFreeBlock(Suballocator* suballocator, uint32 block_index)
+{
+    SuballocatorBlock* block = GetBlock(suballocator, block_index);
+    uint32 fl = 0;
+    uint32 sl = 0;
+    GetSizeClass(block->size, &fl, &sl);
+
+    uint32 head_index = suballocator->free_heads[fl][sl];
+    block->free      = true;
+    block->prev_free = UNSET_INDEX;
+    block->next_free = head_index;
+    if (head_index != UNSET_INDEX)
+    {
+        GetBlock(suballocator, head_index)->prev_free = block_index;
+    }
+    suballocator->free_heads[fl][sl] = block_index;
+    suballocator->sl_bitmaps[fl] |= 1u << sl;
+    suballocator->fl_bitmap |= 1ull << fl;
+}
+
+static void RemoveFreeBlock(Suballocator* suballocator, uint32 block_index)
+{
+    SuballocatorBlock* block = GetBlock(suballocator, block_index);
+    uint32 fl = 0;
+    uint32 sl = 0;
+    GetSizeClass(block->size, &fl, &sl);
+
+    if (block->prev_free != UNSET_INDEX)
+    {
+        GetBlock(suballocator, block->prev_free)->next_free = block->next_free;
+    }
+    else
+    {
+        suballocator->free_heads[fl][sl] = block->next_free;
+    }
+    if (block->next_free != UNSET_INDEX)
+    {
+        GetBlock(suballocator, block->next_free)->prev_free = block->prev_free;
+    }
+
+    if (suballocator->free_heads[fl][sl] == UNSET_INDEX)
+    {
+        suballocator->sl_bitmaps[fl] &= ~(1u << sl);
+        if (suballocator->sl_bitmaps[fl] == 0)
+        {
+            suballocator->fl_bitmap &= ~(1ull << fl);
+        }
+    }
+    block->free = false;
+}
+
+static uint32 FindFreeBlock(Suballocator* suballocator, VkDeviceSize size)
+{
+    // Round size up to next size class so any block in the found class is large enough.
+    if (size >= SUBALLOCATOR_SMALL_SIZE)
+    {
+        size += (1ull << (FindHighestSetBit(size) - SUBALLOCATOR_SL_BITS)) - 1;
+    }
+    uint32 fl = 0;
+    uint32 sl = 0;
+    GetSizeClass(size, &fl, &sl);
+    if (fl >= SUBALLOCATOR_FL_COUNT)
+    {
+        return UNSET_INDEX;
+    }
+
+    // Search current first level for large enough second level, then any larger first level.
+    uint32 sl_bitmap = suballocator->sl_bitmaps[fl] & (~0u << sl);
+    if (sl_bitmap == 0)
+    {
+        uint64 fl_bitmap = fl + 1 < SUBALLOCATOR_FL_COUNT ? suballocator->fl_bitmap & (~0ull << (fl + 1)) : 0;
+        if (fl_bitmap == 0)
+        {
+            return UNSET_INDEX;
+        }
+        fl = FindLowestSetBit(fl_bitmap);
+        sl_bitmap = suballocator->sl_bitmaps[fl];
+    }
+    sl = FindLowestSetBit(sl_bitmap);
+    return suballocator->free_heads[fl][sl];
+}
+
+// Splits block at size, returning index of new block containing the remainder.
+static uint32 SplitBlock(Suballocator* suballocator, uint32 block_index, VkDeviceSize size)
+{
+    uint32 remainder_index = AcquireBlock(suballocator);
+    SuballocatorBlock* block = GetBlock(suballocator, block_index);
+    SuballocatorBlock* remainder = GetBlock(suballocator, remainder_index);
+    remainder->offset    = block->offset + size;
+    remainder->size      = block->size - size;
+    remainder->prev_phys = block_index;
+    remainder->next_phys = block->next_phys;
+    remainder->prev_free = UNSET_INDEX;
+    remainder->next_free = UNSET_INDEX;
+    remainder->free      = false;
+    if (block->next_phys != UNSET_INDEX)
+    {
+        GetBlock(suballocator, block->next_phys)->prev_phys = remainder_index;
+    }
+    block->next_phys = remainder_index;
+    block->size      = size;
+    return remainder_index;
+}
+
+// Merges next block into block and releases next block.
+static void MergeBlocks(Suballocator* suballocator, uint32 block_index, uint32 next_index)
+{
+    SuballocatorBlock* block = GetBlock(suballocator, block_index);
+    SuballocatorBlock* next = GetBlock(suballocator, next_index);
+    block->size += next->size;
+    block->next_phys = next->next_phys;
+    if (next->next_phys != UNSET_INDEX)
+    {
+        GetBlock(suballocator, next->next_phys)->prev_phys = block_index;
+    }
+    ReleaseBlock(suballocator, next_index);
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitSuballocator(Suballocator* suballocator, VkDeviceSize base_offset, VkDeviceSize size)
+{
+    suballocator->base_offset      = base_offset;
+    suballocator->size             = size;
+    suballocator->used             = 0;
+    suballocator->allocation_count = 0;
+    suballocator->fl_bitmap        = 0;
+    memset(suballocator->sl_bitmaps, 0, sizeof(suballocator->sl_bitmaps));
+    memset(suballocator->free_heads, 0xFF, sizeof(suballocator->free_heads)); // UNSET_INDEX
+
+    // Link all blocks into unused list.
+    for (uint32 block_index = 0; block_index < suballocator->max_blocks; ++block_index)
+    {
+        suballocator->blocks[block_index].next_free =
+            block_index + 1 < suballocator->max_blocks ? block_index + 1 : UNSET_INDEX;
+    }
+    suballocator->unused_block_head = 0;
+
+    // Start with a single free block covering entire range.
+    if (size > 0)
+    {
+        uint32 block_index = AcquireBlock(suballocator);
+        SuballocatorBlock* block = GetBlock(suballocator, block_index);
+        block->offset    = base_offset;
+        block->size      = size;
+        block->prev_phys = UNSET_INDEX;
+        block->next_phys = UNSET_INDEX;
+        InsertFreeBlock(suballocator, block_index);
+    }
+}
+
+static Suballocator* CreateSuballocator(Allocator* allocator, uint32 max_allocations, VkDeviceSize base_offset,
+                                        VkDeviceSize size)
+{
+    // Free blocks are always merged, so there is at most 1 free block between allocations.
+    Suballocator* suballocator = Allocate<Suballocator>(allocator, 1);
+    suballocator->max_blocks = (max_allocations * 2) + 1;
+    suballocator->blocks     = Allocate<SuballocatorBlock>(allocator, suballocator->max_blocks);
+    InitSuballocator(suballocator, base_offset, size);
+    return suballocator;
+}
+
+static bool Suballocate(Suballocation* suballocation, Suballocator* suballocator, VkDeviceSize size,
+                        VkDeviceSize alignment)
+{
+    size      = size      > 0 ? size      : 1;
+    alignment = alignment > 0 ? alignment : 1;
+
+    // Search with worst-case alignment padding included so found block is guaranteed to fit.
+    uint32 block_index = FindFreeBlock(suballocator, size + alignment - 1);
+    if (block_index == UNSET_INDEX)
+    {
+        return false;
+    }
+    RemoveFreeBlock(suballocator, block_index);
+
+    // Split off alignment padding as its own free block.
+    SuballocatorBlock* block = GetBlock(suballocator, block_index);
+    VkDeviceSize padding = Align(block->offset, alignment) - block->offset;
+    if (padding > 0)
+    {
+        uint32 padding_index = block_index;
+        block_index = SplitBlock(suballocator, padding_index, padding);
+        InsertFreeBlock(suballocator, padding_index);
+        block = GetBlock(suballocator, block_index);
+    }
+
+    // Split off unused remainder as its own free block.
+    if (block->size > size)
+    {
+        InsertFreeBlock(suballocator, SplitBlock(suballocator, block_index, size));
+        block = GetBlock(suballocator, block_index);
+    }
+
+    suballocator->used += block->size;
+    ++suballocator->allocation_count;
+    suballocation->offset      = block->offset;
+    suballocation->block_index = block_index;
+    return true;
+}
+
+static void FreeSuballocation(Suballocator* suballocator, uint32 block_index)
+{
+    SuballocatorBlock* block = GetBlock(suballocator, block_index);
+    CTK_ASSERT(!block->free);
+    suballocator->used -= block->size;
+    --suballocator->allocation_count;
+
+    // Merge with free neighbours; free blocks are always merged, so neighbours' neighbours are never free.
+    if (block->next_phys != UNSET_INDEX && GetBlock(suballocator, block->next_phys)->free)
+    {
+        uint32 next_index = block->next_phys;
+        RemoveFreeBlock(suballocator, next_index);
+        MergeBlocks(suballocator, block_index, next_index);
+    }
+    if (block->prev_phys != UNSET_INDEX && GetBlock(suballocator, block->prev_phys)->free)
+    {
+        uint32 prev_index = block->prev_phys;
+        RemoveFreeBlock(suballocator, prev_index);
+        MergeBlocks(suballocator, prev_index, block_index);
+        block_index = prev_index;
+    }
+    InsertFreeBlock(suballocator, block_index);
+}
+
+// End of last allocated range; everything after it is one free block. Block 0 always starts the physical block list,
+// since splits keep the lower range in the original block and merges keep the lower block.
+static VkDeviceSize GetSuballocatorExtent(Suballocator* suballocator)
+{
+    VkDeviceSize extent = suballocator->base_offset;
+    if (suballocator->size == 0)
+    {
+        return extent;
+    }
+
+    uint32 block_index = 0;
+    while (block_index != UNSET_INDEX)
+    {
+        SuballocatorBlock* block = GetBlock(suballocator, block_index);
+        if (!block->free)
+        {
+            extent = block->offset + block->size;
+        }
+        block_index = block->next_phys;
+    }
+    return extent;
+}
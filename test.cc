@@ -5,6 +5,19 @@ using namespace RTK;
 #include "rtk/tests/defs.h"
 #include "rtk/tests/render_state.h"
 #include "rtk/tests/game_state.h"
+#include "rtk/tests/upload_tests.h"
+#include "rtk/tests/resource_thread_tests.h"
+#include "rtk/tests/stream_copy_tests.h"
+
+// Frame stats stage indexes; stage 0 is the built-in whole-frame stage.
+enum FrameStatsStage : uint32
+{
+    STAGE_UPDATE = 1,
+    STAGE_ACQUIRE,
+    STAGE_MVP_MATRIXES,
+    STAGE_RECORD,
+    STAGE_SUBMIT,
+};
 
 sint32 main()
 {
@@ -15,6 +28,14 @@ sint32 main()
     ThreadPool thread_pool = {};
     InitThreadPool(&thread_pool, &perm_stack, 8, Kilobyte32<4>());
 
+    // Trace main thread + thread pool threads.
+    CPUTracerInfo cpu_tracer_info =
+    {
+        .max_threads           = thread_pool.thread_count + 1,
+        .max_events_per_thread = 4096,
+    };
+    InitCPUTracer(&perm_stack, &cpu_tracer_info);
+
     // Make win32 process DPI aware so windows scale properly.
     SetProcessDPIAware();
 
@@ -45,6 +66,7 @@ sint32 main()
                                                         VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
 #endif
     context_info.render_thread_count = 6;
+    context_info.pipeline_cache_path = "pipeline_cache.bin";
 
     InitDeviceFeatures(&context_info.enabled_features);
     context_info.enabled_features.vulkan_1_0.geometryShader                            = VK_TRUE;
@@ -53,17 +75,43 @@ sint32 main()
     context_info.enabled_features.vulkan_1_2.scalarBlockLayout                         = VK_TRUE;
 
     InitContext(&perm_stack, &free_list, &context_info);
+    LogPhysicalDevices();
+    LogFrames();
 // LogPhysicalDevice(GetPhysicalDevice());
 
     // Initialize other test state.
     InitRenderState(&perm_stack, &free_list, thread_pool.thread_count);
     InitGameState(&perm_stack);
+    RunUploadTests(&perm_stack);
+    RunStreamCopyTests(g_render_state.staging_buffer);
+    RunResourceThreadTests(&perm_stack, &thread_pool);
+    InitDescriptorSets();
 LogResourceGroups();
 
+    // Frame-time stats; CPU stage budgets are rough splits of a 60hz frame.
+    FrameStageInfo frame_stage_infos[] =
+    {
+        { .name = "update",       .budget_ms = 2.0 },
+        { .name = "acquire",      .budget_ms = 8.0 },
+        { .name = "mvp matrixes", .budget_ms = 2.0 },
+        { .name = "record",       .budget_ms = 4.0 },
+        { .name = "submit",       .budget_ms = 2.0 },
+    };
+    FrameStatsInfo frame_stats_info =
+    {
+        .frame_budget_ms = 1000.0 / 60.0,
+        .bucket_width_ms = 0.05,
+        .bucket_count    = 2000, // 100ms
+        .stages          = CTK_WRAP_ARRAY(frame_stage_infos),
+    };
+    FrameStats frame_stats = {};
+    InitFrameStats(&frame_stats, &perm_stack, &frame_stats_info);
+
     // Run game.
     bool recreate_swapchain = false;
     for (;;)
     {
+        RTK_TRACE_SCOPE("Frame");
         ProcessWindowEvents();
         if (!WindowIsOpen())
         {
@@ -75,7 +123,9 @@ LogResourceGroups();
             continue;
         }
 
+        uint64 stage_start_ns = GetTimeNS();
         UpdateGame();
+        RecordFrameStage(&frame_stats, STAGE_UPDATE, stage_start_ns);
         if (!WindowIsOpen())
         {
             break; // Game controls closed window.
@@ -91,8 +141,11 @@ LogResourceGroups();
             continue;
         }
 
+        TickFrameStats(&frame_stats);
         NextFrame();
+        stage_start_ns = GetTimeNS();
         VkResult acquire_swapchain_image_res = AcquireSwapchainImage();
+        RecordFrameStage(&frame_stats, STAGE_ACQUIRE, stage_start_ns);
         if (acquire_swapchain_image_res == VK_ERROR_OUT_OF_DATE_KHR)
         {
             // Swapchain image acquisition failed, recreate swapchain, skip rendering and move to next iteration to
@@ -110,9 +163,15 @@ LogResourceGroups();
         }
 
         EntityData* entity_data = GetEntityData();
+        stage_start_ns = GetTimeNS();
         UpdateMVPMatrixes(&thread_pool, GetView(), entity_data->transforms, entity_data->count);
+        RecordFrameStage(&frame_stats, STAGE_MVP_MATRIXES, stage_start_ns);
+        stage_start_ns = GetTimeNS();
         RecordRenderCommands(&thread_pool, entity_data->count);
+        RecordFrameStage(&frame_stats, STAGE_RECORD, stage_start_ns);
+        stage_start_ns = GetTimeNS();
         VkResult submit_render_commands_res = SubmitRenderCommands(GetRenderTarget());
+        RecordFrameStage(&frame_stats, STAGE_SUBMIT, stage_start_ns);
 
         if (recreate_swapchain ||
             submit_render_commands_res == VK_ERROR_OUT_OF_DATE_KHR ||
@@ -122,4 +181,11 @@ LogResourceGroups();
             recreate_swapchain = false;
         }
     }
+
+    LogFrameStats(&frame_stats);
+    WriteFrameStatsCSV(&frame_stats, "frame_stats.csv");
+    WriteFrameStatsJSON(&frame_stats, "frame_stats.json");
+    LogGPUProfiler();
+    WriteCPUTrace("cpu_trace.json");
+    SavePipelineCache();
 }
@@ -71,6 +71,9 @@ struct RenderState
     VkShaderModule   frag_shader;
     VertexLayout     vertex_layout;
     Pipeline         pipeline;
+
+    // Profiling
+    GPUScopeHnd entities_gpu_scope;
 };
 
 static constexpr const char* TEXTURE_IMAGE_PATHS[] =
@@ -101,6 +104,7 @@ static void InitThreadPoolJob(Job<StateType>* job, Allocator* allocator, uint32
 static void CreateResources(Stack* perm_stack, FreeList* free_list)
 {
     InitResourceModule(perm_stack, { .max_resource_groups = 4 });
+    InitUploadModule(perm_stack, { .max_pending_uploads = 4 });
 
     ResourceGroupInfo res_group_info =
     {
@@ -145,6 +149,18 @@ static void CreateResources(Stack* perm_stack, FreeList* free_list)
     };
     g_render_state.image_mem = DefineImageMemory(g_render_state.res_group, &image_mem_info);
 
+    // Entity buffer is defined on its own so it's placed in device local host visible memory when available.
+    BufferInfo entity_buffer_info =
+    {
+        .size       = sizeof(EntityBuffer),
+        .alignment  = USE_MIN_OFFSET_ALIGNMENT,
+        .per_frame  = true,
+        .flags      = 0,
+        .usage      = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        .properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    };
+    g_render_state.entity_buffer = DefineBuffer(g_render_state.res_group, &entity_buffer_info);
+
     AllocateResourceGroup(g_render_state.res_group);
 
     // Staging Buffer
@@ -155,15 +171,11 @@ static void CreateResources(Stack* perm_stack, FreeList* free_list)
         .per_frame = false,
     };
     g_render_state.staging_buffer = CreateBuffer(g_render_state.host_buffer, &staging_buffer_info);
+    StagingRingInfo staging_ring_info = { .buffer = g_render_state.staging_buffer };
+    InitStagingRing(perm_stack, &staging_ring_info);
 
-    // Entity Buffer
-    BufferInfo entity_buffer_info =
-    {
-        .size      = sizeof(EntityBuffer),
-        .alignment = USE_MIN_OFFSET_ALIGNMENT,
-        .per_frame = true,
-    };
-    g_render_state.entity_buffer = CreateBuffer(g_render_state.host_buffer, &entity_buffer_info);
+    // Textures and meshes are streamed through the staging ring and uploaded together in a single submission.
+    BeginUpload();
 
     // Textures
     g_render_state.textures = CreateArray<ImageHnd>(perm_stack, TEXTURE_COUNT);
@@ -203,7 +215,7 @@ static void CreateResources(Stack* perm_stack, FreeList* free_list)
         };
         ImageHnd texture = CreateImage(g_render_state.image_mem, &texture_info, &texture_view_info);
         Push(&g_render_state.textures, texture);
-        LoadImage(texture, g_render_state.staging_buffer, 0, &texture_data);
+        StageImageUploadCmd(texture, 0, &texture_data);
         DestroyImageData(&texture_data);
     }
 
@@ -216,7 +228,7 @@ static void CreateResources(Stack* perm_stack, FreeList* free_list)
     };
     static constexpr uint32 MESH_COUNT = CTK_ARRAY_SIZE(MESH_PATHS);
 
-    InitMeshModule(perm_stack, { .max_mesh_groups = 1 });
+    InitMeshModule(perm_stack, { .max_mesh_groups = 2 }); // Second group is for resource thread tests.
 
     MeshGroupInfo mesh_group_info =
     {
@@ -235,9 +247,10 @@ static void CreateResources(Stack* perm_stack, FreeList* free_list)
         LoadMeshData(&mesh_data, free_list, *mesh_path, &attribute_swizzles);
         MeshHnd mesh = CreateMesh(g_render_state.mesh_group, &mesh_data.info);
         Push(&g_render_state.meshes, mesh);
-        LoadDeviceMesh(mesh, g_render_state.staging_buffer, &mesh_data);
+        LoadDeviceMeshCmd(mesh, &mesh_data);
         DestroyMeshData(&mesh_data, free_list);
     }
+    WaitUpload(SubmitUpload());
 }
 
 static void CreateSamplers(Stack* perm_stack)
@@ -334,7 +347,7 @@ static void CreateDescriptorSets(Stack* perm_stack)
         g_render_state.textures_descriptor_set = CreateDescriptorSet(perm_stack, CTK_WRAP_ARRAY(datas));
     }
 
-    InitDescriptorSets();
+    // Descriptor sets are allocated by InitDescriptorSets() once tests have created theirs.
 }
 
 static void InitRenderTargets(Stack* perm_stack, FreeList* free_list)
@@ -430,13 +443,20 @@ static void InitPipelines(FreeList* free_list)
         .render_target = &g_render_state.render_target,
     };
 
+    // Log pipeline creation time to compare cold (empty) and warm (loaded from disk) pipeline cache startups.
+    uint64 start_ns = GetTimeNS();
     InitPipeline(&g_render_state.pipeline, free_list, &pipeline_info, &pipeline_layout_info);
+    float64 elapsed_ms = GetElapsedMS(start_ns);
+    PrintLine("pipeline creation (%s pipeline cache): %.3fms", PipelineCacheIsWarm() ? "warm" : "cold", elapsed_ms);
 }
 
 static void RecordRenderCommandsThread(void* data)
 {
+    RTK_TRACE_SCOPE("RecordRenderCommandsThread");
     auto state = (RenderCommandState*)data;
     VkCommandBuffer command_buffer = BeginRenderCommands(&g_render_state.render_target, state->thread_index);
+    GPUScopeRecord entities_gpu_scope = BeginGPUScope(command_buffer, g_render_state.entities_gpu_scope,
+                                                      state->thread_index);
         Pipeline* pipeline = &g_render_state.pipeline;
         DescriptorSetHnd descriptor_sets[] =
         {
@@ -454,6 +474,7 @@ static void RecordRenderCommandsThread(void* data)
             DrawMesh(command_buffer, state->mesh, i, 1);
         }
 #endif
+    EndGPUScope(command_buffer, entities_gpu_scope);
     EndRenderCommands(command_buffer);
 }
 
@@ -484,10 +505,14 @@ static Matrix GetViewProjectionMatrix(View* view)
 
 static void UpdateMVPMatrixesThread(void* data)
 {
+    RTK_TRACE_SCOPE("UpdateMVPMatrixesThread");
     auto state = (MVPMatrixState*)data;
     BatchRange batch_range = state->batch_range;
 
-    // Update entity MVP matrixes.
+    // Update entity MVP matrixes. Entity buffer is uncached mapped memory, so matrixes are streamed in whole cache
+    // lines rather than stored piecemeal.
+    StreamWriter writer;
+    BeginStreamWrite(&writer, &state->frame_entity_buffer->mvp_matrixes[batch_range.start]);
     for (uint32 i = batch_range.start; i < batch_range.start + batch_range.size; ++i)
     {
         Transform* entity_transform = &state->transforms[i];
@@ -498,14 +523,16 @@ static void UpdateMVPMatrixesThread(void* data)
         model_matrix = RotateZ  (model_matrix, entity_transform->rotation.z);
         // model_matrix = Scale    (model_matrix, entity_transform->scale);
 
-        state->frame_entity_buffer->mvp_matrixes[i] = state->view_projection_matrix * model_matrix;
+        Matrix mvp_matrix = state->view_projection_matrix * model_matrix;
+        StreamWrite(&writer, &mvp_matrix, sizeof(Matrix));
     }
+    EndStreamWrite(&writer);
 }
 
 static void RecreateSwapchain(FreeList* free_list)
 {
-    WaitIdle();
-
+    // Old swapchain and attachments are retired through the frame ring, so there's no need to wait for the device to
+    // idle.
     UpdateSwapchainSurfaceExtent(free_list);
 
     VkExtent2D swapchain_extent = GetSwapchain()->surface_extent;
@@ -520,7 +547,7 @@ static void RecreateSwapchain(FreeList* free_list)
     };
     UpdatePipelineViewports(&g_render_state.pipeline, CTK_WRAP_ARRAY_1(&viewport));
 
-    UpdateRenderTargetAttachments(&g_render_state.render_target, free_list);
+    UpdateRenderTargetAttachments(&g_render_state.render_target);
 }
 
 /// Interface
@@ -530,6 +557,16 @@ static void InitRenderState(Stack* perm_stack, FreeList* free_list, uint32 mvp_m
     InitThreadPoolJob(&g_render_state.render_command_job, perm_stack, GetRenderThreadCount());
     InitThreadPoolJob(&g_render_state.mvp_matrix_job, perm_stack, mvp_matrix_job_thread_count);
 
+    // Profiling
+    GPUProfilerInfo gpu_profiler_info =
+    {
+        .max_scopes             = 4,
+        .max_records_per_thread = 4,
+        .sample_count           = 256,
+    };
+    InitGPUProfiler(perm_stack, &gpu_profiler_info);
+    g_render_state.entities_gpu_scope = RegisterGPUScope(perm_stack, "entities");
+
     // Resources
     CreateResources(perm_stack, free_list);
 
@@ -547,7 +584,7 @@ static void SetTextureIndexes(uint32* texture_indexes, uint32 entity_count, uint
     CTK_ASSERT(entity_count <= MAX_ENTITIES);
     CTK_ASSERT(frame_index < GetFrameCount());
     EntityBuffer* frame_entity_buffer = GetMappedMemory<EntityBuffer>(g_render_state.entity_buffer, frame_index);
-    memcpy(frame_entity_buffer->texture_indexes, texture_indexes, sizeof(uint32) * entity_count);
+    StreamCopy(frame_entity_buffer->texture_indexes, texture_indexes, sizeof(uint32) * entity_count);
 }
 
 static void SetSamplerIndexes(uint32* sampler_indexes, uint32 entity_count, uint32 frame_index)
@@ -555,11 +592,12 @@ static void SetSamplerIndexes(uint32* sampler_indexes, uint32 entity_count, uint
     CTK_ASSERT(entity_count <= MAX_ENTITIES);
     CTK_ASSERT(frame_index < GetFrameCount());
     EntityBuffer* frame_entity_buffer = GetMappedMemory<EntityBuffer>(g_render_state.entity_buffer, frame_index);
-    memcpy(frame_entity_buffer->sampler_indexes, sampler_indexes, sizeof(uint32) * entity_count);
+    StreamCopy(frame_entity_buffer->sampler_indexes, sampler_indexes, sizeof(uint32) * entity_count);
 }
 
 static void UpdateMVPMatrixes(ThreadPool* thread_pool, View* view, Transform* transforms, uint32 entity_count)
 {
+    RTK_TRACE_SCOPE("UpdateMVPMatrixes");
     Job<MVPMatrixState>* job = &g_render_state.mvp_matrix_job;
     Matrix view_projection_matrix = GetViewProjectionMatrix(view);
     auto frame_entity_buffer = GetMappedMemory<EntityBuffer>(g_render_state.entity_buffer, GetFrameIndex());
@@ -587,6 +625,7 @@ static void UpdateMVPMatrixes(ThreadPool* thread_pool, View* view, Transform* tr
 
 static void RecordRenderCommands(ThreadPool* thread_pool, uint32 entity_count)
 {
+    RTK_TRACE_SCOPE("RecordRenderCommands");
     Job<RenderCommandState>* job = &g_render_state.render_command_job;
 
     uint32 thread_count = job->states.count;
@@ -0,0 +1,337 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint32 THREAD_TEST_TASK_COUNT          = 8;
+static constexpr uint32 THREAD_TEST_BUFFERS_PER_TASK    = 8;
+static constexpr uint32 THREAD_TEST_IMAGES_PER_TASK     = 4;
+static constexpr uint32 THREAD_TEST_MESHES_PER_TASK     = 8;
+static constexpr uint32 THREAD_TEST_MESH_VERTEX_SIZE    = 20;
+static constexpr uint32 THREAD_TEST_MESH_VERTEX_COUNT   = 24;
+static constexpr uint32 THREAD_TEST_MESH_INDEX_SIZE     = sizeof(uint32);
+static constexpr uint32 THREAD_TEST_MESH_INDEX_COUNT    = 36;
+static constexpr uint32 THREAD_TEST_MESH_GROUP_BUFFERS  = 2; // Mesh group's vertex and index buffers.
+static constexpr uint32 THREAD_TEST_MAX_BUFFERS =
+    1 + THREAD_TEST_MESH_GROUP_BUFFERS + THREAD_TEST_TASK_COUNT * THREAD_TEST_BUFFERS_PER_TASK;
+static constexpr uint32 THREAD_TEST_MAX_IMAGES = THREAD_TEST_TASK_COUNT * THREAD_TEST_IMAGES_PER_TASK;
+static constexpr uint32 THREAD_TEST_MAX_MESHES = THREAD_TEST_TASK_COUNT * THREAD_TEST_MESHES_PER_TASK;
+
+struct ResourceThreadTestState
+{
+    uint32           task_index;
+    Stack            stack; // Descriptor set allocator; only used by task's thread.
+    BufferHnd        buffers[THREAD_TEST_BUFFERS_PER_TASK];
+    ImageHnd         images [THREAD_TEST_IMAGES_PER_TASK];
+    MeshHnd          meshes [THREAD_TEST_MESHES_PER_TASK];
+    DescriptorSetHnd descriptor_set;
+};
+
+struct ResourceThreadTest
+{
+    ResourceGroupHnd        res_group;
+    BufferHnd               parent_buffer;
+    ImageMemoryHnd          image_mem;
+    MeshGroupHnd            mesh_group;
+    ResourceThreadTestState states[THREAD_TEST_TASK_COUNT];
+    TaskHnd                 tasks [THREAD_TEST_TASK_COUNT];
+};
+
+// Range of memory owned by a resource; ranges can only overlap if they're in the same memory and page.
+struct ResourceRange
+{
+    uint32       index;
+    uint32       mem_index;
+    uint32       page_index;
+    VkDeviceSize start;
+    VkDeviceSize end;
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+// Test resources stay alive for the rest of the run, since descriptor sets created by tests are written every frame.
+static ResourceThreadTest g_resource_thread_test;
+
+/// Utils
+////////////////////////////////////////////////////////////
+static void CreateResourcesThread(void* data)
+{
+    auto state = (ResourceThreadTestState*)data;
+
+    // Vary sizes so concurrent suballocations don't line up on the same boundaries.
+    for (uint32 i = 0; i < THREAD_TEST_BUFFERS_PER_TASK; ++i)
+    {
+        BufferInfo buffer_info =
+        {
+            .size      = 256 * (1 + (state->task_index + i) % 4),
+            .alignment = USE_MIN_OFFSET_ALIGNMENT,
+            .per_frame = (i % 2) == 1,
+        };
+        state->buffers[i] = CreateBuffer(g_resource_thread_test.parent_buffer, &buffer_info);
+    }
+
+    for (uint32 i = 0; i < THREAD_TEST_IMAGES_PER_TASK; ++i)
+    {
+        uint32 image_size = 16u << ((state->task_index + i) % 3);
+        ImageInfo image_info =
+        {
+            .extent         = { .width = image_size, .height = image_size, .depth = 1 },
+            .type           = VK_IMAGE_TYPE_2D,
+            .mip_levels     = 1,
+            .array_layers   = 1,
+            .samples        = VK_SAMPLE_COUNT_1_BIT,
+            .initial_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .per_frame      = (i % 2) == 1,
+        };
+        ImageViewInfo image_view_info =
+        {
+            .flags      = 0,
+            .type       = VK_IMAGE_VIEW_TYPE_2D,
+            .components = RGBA_COMPONENT_SWIZZLE_IDENTITY,
+            .subresource_range =
+            {
+                .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel   = 0,
+                .levelCount     = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount     = VK_REMAINING_ARRAY_LAYERS,
+            },
+        };
+        state->images[i] = CreateImage(g_resource_thread_test.image_mem, &image_info, &image_view_info);
+    }
+
+    MeshInfo mesh_info =
+    {
+        .vertex_size  = THREAD_TEST_MESH_VERTEX_SIZE,
+        .vertex_count = THREAD_TEST_MESH_VERTEX_COUNT,
+        .index_size   = THREAD_TEST_MESH_INDEX_SIZE,
+        .index_count  = THREAD_TEST_MESH_INDEX_COUNT,
+    };
+    for (uint32 i = 0; i < THREAD_TEST_MESHES_PER_TASK; ++i)
+    {
+        state->meshes[i] = CreateMesh(g_resource_thread_test.mesh_group, &mesh_info);
+    }
+
+    DescriptorData datas[] =
+    {
+        {
+            .type        = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .stages      = VK_SHADER_STAGE_VERTEX_BIT,
+            .count       = THREAD_TEST_BUFFERS_PER_TASK,
+            .buffer_hnds = state->buffers,
+        },
+    };
+    state->descriptor_set = CreateDescriptorSet(&state->stack, CTK_WRAP_ARRAY(datas));
+}
+
+static void ValidateUniqueIndex(bool* used, uint32 max, uint32 index, const char* resource)
+{
+    if (index >= max)
+    {
+        CTK_FATAL("resource thread test failed: %s index %u exceeds max of %u", resource, index, max);
+    }
+    if (used[index])
+    {
+        CTK_FATAL("resource thread test failed: %s index %u was handed out more than once", resource, index);
+    }
+    used[index] = true;
+}
+
+static void ValidateNoOverlap(Array<ResourceRange>* ranges, const char* resource)
+{
+    for (uint32 a = 0; a < ranges->count; ++a)
+    for (uint32 b = a + 1; b < ranges->count; ++b)
+    {
+        ResourceRange* range_a = GetPtr(ranges, a);
+        ResourceRange* range_b = GetPtr(ranges, b);
+        if (range_a->mem_index  == range_b->mem_index  &&
+            range_a->page_index == range_b->page_index &&
+            range_a->start < range_b->end && range_b->start < range_a->end)
+        {
+            CTK_FATAL("resource thread test failed: %s %u range [%llu, %llu) overlaps %s %u range [%llu, %llu)",
+                      resource, range_a->index, range_a->start, range_a->end,
+                      resource, range_b->index, range_b->start, range_b->end);
+        }
+    }
+}
+
+static void PushBufferRanges(Array<ResourceRange>* ranges, BufferHnd buffer_hnd)
+{
+    BufferState* buffer_state = GetBufferState(buffer_hnd);
+    for (uint32 frame_index = 0; frame_index < buffer_state->frame_count; ++frame_index)
+    {
+        VkDeviceSize offset = GetBufferFrameState(buffer_hnd, frame_index)->res_mem_offset;
+        Push(ranges,
+             {
+                 .index      = buffer_hnd.index,
+                 .mem_index  = buffer_state->res_mem_index,
+                 .page_index = buffer_state->page_index,
+                 .start      = offset,
+                 .end        = offset + buffer_state->size,
+             });
+    }
+}
+
+static void PushImageRanges(Array<ResourceRange>* ranges, ImageHnd image_hnd)
+{
+    ResourceGroup* res_group = GetResourceGroup(image_hnd.group_index);
+    ImageState* image_state = GetImageState(res_group, image_hnd.index);
+    if (image_state->dedicated)
+    {
+        return; // Dedicated images have their own device memory.
+    }
+    for (uint32 frame_index = 0; frame_index < image_state->frame_count; ++frame_index)
+    {
+        VkDeviceSize offset = GetImageFrameState(res_group, image_hnd.index, frame_index)->image_mem_offset;
+        Push(ranges,
+             {
+                 .index      = image_hnd.index,
+                 .mem_index  = image_state->image_mem_index,
+                 .page_index = image_state->page_index,
+                 .start      = offset,
+                 .end        = offset + image_state->size,
+             });
+    }
+}
+
+static void PushMeshRange(Array<ResourceRange>* ranges, MeshHnd mesh_hnd, uint32 offset, uint32 size,
+                          uint32 buffer_size)
+{
+    if (offset + size > buffer_size)
+    {
+        CTK_FATAL("resource thread test failed: mesh %u range [%u, %u) exceeds mesh group buffer size of %u",
+                  mesh_hnd.index, offset, offset + size, buffer_size);
+    }
+    Push(ranges, { .index = mesh_hnd.index, .mem_index = 0, .page_index = 0, .start = offset, .end = offset + size });
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+// Creates buffers, images, meshes and descriptor sets from every thread pool thread at once, then checks no handle was
+// handed out twice and no suballocations overlap. Must be called before InitDescriptorSets().
+static void RunResourceThreadTests(Stack* perm_stack, ThreadPool* thread_pool)
+{
+    CTK::Frame frame = CreateFrame();
+    ResourceThreadTest* test = &g_resource_thread_test;
+    if (thread_pool->thread_count < THREAD_TEST_TASK_COUNT)
+    {
+        CTK_FATAL("resource thread test failed: needs %u threads, but thread pool only has %u",
+                  THREAD_TEST_TASK_COUNT, thread_pool->thread_count);
+    }
+
+    // Parent resources are created up front on this thread; only their suballocations are created concurrently.
+    ResourceGroupInfo res_group_info =
+    {
+        .max_buffers    = THREAD_TEST_MAX_BUFFERS,
+        .max_image_mems = 1,
+        .max_images     = THREAD_TEST_MAX_IMAGES,
+    };
+    test->res_group = CreateResourceGroup(perm_stack, &res_group_info);
+    BufferInfo parent_buffer_info =
+    {
+        .size       = Megabyte32<1>(),
+        .alignment  = USE_MIN_OFFSET_ALIGNMENT,
+        .per_frame  = false,
+        .flags      = 0,
+        .usage      = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        .properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    };
+    test->parent_buffer = DefineBuffer(test->res_group, &parent_buffer_info);
+    ImageMemoryInfo image_mem_info =
+    {
+        .size       = Megabyte32<4>(),
+        .flags      = 0,
+        .usage      = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .format     = VK_FORMAT_R8G8B8A8_UNORM,
+        .tiling     = VK_IMAGE_TILING_OPTIMAL,
+    };
+    test->image_mem = DefineImageMemory(test->res_group, &image_mem_info);
+    AllocateResourceGroup(test->res_group);
+
+    MeshGroupInfo mesh_group_info =
+    {
+        .max_meshes         = THREAD_TEST_MAX_MESHES,
+        .vertex_buffer_size = THREAD_TEST_MAX_MESHES * THREAD_TEST_MESH_VERTEX_COUNT * THREAD_TEST_MESH_VERTEX_SIZE,
+        .index_buffer_size  = THREAD_TEST_MAX_MESHES * THREAD_TEST_MESH_INDEX_COUNT  * THREAD_TEST_MESH_INDEX_SIZE,
+    };
+    test->mesh_group = CreateMeshGroup(perm_stack, test->parent_buffer, &mesh_group_info);
+
+    // Create resources from all tasks at once.
+    for (uint32 task_index = 0; task_index < THREAD_TEST_TASK_COUNT; ++task_index)
+    {
+        ResourceThreadTestState* state = &test->states[task_index];
+        state->task_index = task_index;
+        state->stack      = CreateStack(perm_stack, Kilobyte32<1>());
+    }
+    for (uint32 task_index = 0; task_index < THREAD_TEST_TASK_COUNT; ++task_index)
+    {
+        test->tasks[task_index] = SubmitTask(thread_pool, &test->states[task_index], CreateResourcesThread);
+    }
+    CTK_ITER_PTR(task, test->tasks, THREAD_TEST_TASK_COUNT)
+    {
+        Wait(thread_pool, *task);
+    }
+
+    // Handles must be unique.
+    MeshGroup* mesh_group = GetMeshGroup(test->mesh_group.index);
+    uint32 max_descriptor_sets = g_desc_state.max_sets;
+    bool* used_buffers         = Allocate<bool>(&frame, THREAD_TEST_MAX_BUFFERS);
+    bool* used_images          = Allocate<bool>(&frame, THREAD_TEST_MAX_IMAGES);
+    bool* used_meshes          = Allocate<bool>(&frame, THREAD_TEST_MAX_MESHES);
+    bool* used_descriptor_sets = Allocate<bool>(&frame, max_descriptor_sets);
+    memset(used_buffers,         0, sizeof(bool) * THREAD_TEST_MAX_BUFFERS);
+    memset(used_images,          0, sizeof(bool) * THREAD_TEST_MAX_IMAGES);
+    memset(used_meshes,          0, sizeof(bool) * THREAD_TEST_MAX_MESHES);
+    memset(used_descriptor_sets, 0, sizeof(bool) * max_descriptor_sets);
+    ValidateUniqueIndex(used_buffers, THREAD_TEST_MAX_BUFFERS, test->parent_buffer.index, "buffer");
+    ValidateUniqueIndex(used_buffers, THREAD_TEST_MAX_BUFFERS, mesh_group->vertex_buffer.index, "buffer");
+    ValidateUniqueIndex(used_buffers, THREAD_TEST_MAX_BUFFERS, mesh_group->index_buffer.index, "buffer");
+    CTK_ITER_PTR(state, test->states, THREAD_TEST_TASK_COUNT)
+    {
+        CTK_ITER_PTR(buffer, state->buffers, THREAD_TEST_BUFFERS_PER_TASK)
+        {
+            ValidateUniqueIndex(used_buffers, THREAD_TEST_MAX_BUFFERS, buffer->index, "buffer");
+        }
+        CTK_ITER_PTR(image, state->images, THREAD_TEST_IMAGES_PER_TASK)
+        {
+            ValidateUniqueIndex(used_images, THREAD_TEST_MAX_IMAGES, image->index, "image");
+        }
+        CTK_ITER_PTR(mesh, state->meshes, THREAD_TEST_MESHES_PER_TASK)
+        {
+            ValidateUniqueIndex(used_meshes, THREAD_TEST_MAX_MESHES, mesh->index, "mesh");
+        }
+        ValidateUniqueIndex(used_descriptor_sets, max_descriptor_sets, state->descriptor_set.index, "descriptor set");
+    }
+
+    // Suballocations must not overlap. Each buffer and image contributes one range per frame.
+    uint32 frame_count = GetFrameCount();
+    auto buffer_ranges = CreateArray<ResourceRange>(&frame, THREAD_TEST_MAX_BUFFERS * frame_count);
+    auto image_ranges  = CreateArray<ResourceRange>(&frame, THREAD_TEST_MAX_IMAGES  * frame_count);
+    auto vertex_ranges = CreateArray<ResourceRange>(&frame, THREAD_TEST_MAX_MESHES);
+    auto index_ranges  = CreateArray<ResourceRange>(&frame, THREAD_TEST_MAX_MESHES);
+    PushBufferRanges(&buffer_ranges, mesh_group->vertex_buffer);
+    PushBufferRanges(&buffer_ranges, mesh_group->index_buffer);
+    CTK_ITER_PTR(state, test->states, THREAD_TEST_TASK_COUNT)
+    {
+        CTK_ITER_PTR(buffer, state->buffers, THREAD_TEST_BUFFERS_PER_TASK)
+        {
+            PushBufferRanges(&buffer_ranges, *buffer);
+        }
+        CTK_ITER_PTR(image, state->images, THREAD_TEST_IMAGES_PER_TASK)
+        {
+            PushImageRanges(&image_ranges, *image);
+        }
+        CTK_ITER_PTR(mesh_hnd, state->meshes, THREAD_TEST_MESHES_PER_TASK)
+        {
+            Mesh* mesh = GetMesh(*mesh_hnd);
+            PushMeshRange(&vertex_ranges, *mesh_hnd, mesh->vertex_buffer_offset,
+                          THREAD_TEST_MESH_VERTEX_COUNT * THREAD_TEST_MESH_VERTEX_SIZE, mesh_group->vertex_buffer_size);
+            PushMeshRange(&index_ranges, *mesh_hnd, mesh->index_buffer_offset,
+                          THREAD_TEST_MESH_INDEX_COUNT * THREAD_TEST_MESH_INDEX_SIZE, mesh_group->index_buffer_size);
+        }
+    }
+    ValidateNoOverlap(&buffer_ranges, "buffer");
+    ValidateNoOverlap(&image_ranges,  "image");
+    ValidateNoOverlap(&vertex_ranges, "mesh vertex");
+    ValidateNoOverlap(&index_ranges,  "mesh index");
+}
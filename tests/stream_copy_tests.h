@@ -0,0 +1,121 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint32 STREAM_COPY_TEST_SIZE        = 5000;
+static constexpr uint32 STREAM_COPY_TEST_ITERATIONS  = 20000;
+static constexpr uint32 STREAM_COPY_TEST_MAX_OFFSET  = 2 * CACHE_LINE_SIZE;
+static constexpr uint32 STREAM_COPY_TEST_MAX_COPY    = 4000;
+static constexpr uint32 STREAM_COPY_TEST_MAX_WRITE   = 200;
+static constexpr uint32 STREAM_COPY_BENCH_SIZE       = Megabyte32<4>();
+static constexpr uint32 STREAM_COPY_BENCH_ITERATIONS = 32;
+static constexpr uint32 STREAM_COPY_BENCH_WRITE_SIZE = sizeof(Matrix); // Matches MVP matrix writes.
+
+enum struct StreamCopyMethod
+{
+    MEMCPY,
+    STREAM_COPY,
+    STREAM_WRITER,
+};
+
+/// Utils
+////////////////////////////////////////////////////////////
+static void StreamCopyWithMethod(StreamCopyMethod method, uint8* dst, uint8* src, uint32 size, uint32 max_write_size)
+{
+    if (method == StreamCopyMethod::MEMCPY)
+    {
+        memcpy(dst, src, size);
+    }
+    else if (method == StreamCopyMethod::STREAM_COPY)
+    {
+        StreamCopy(dst, src, size);
+    }
+    else
+    {
+        StreamWriter writer = {};
+        BeginStreamWrite(&writer, dst);
+        for (uint32 written = 0; written < size;)
+        {
+            uint32 write_size = Min(size - written, max_write_size);
+            StreamWrite(&writer, &src[written], write_size);
+            written += write_size;
+        }
+        EndStreamWrite(&writer);
+    }
+}
+
+// Copies random sizes to random destination alignments, checking bytes before and after the destination range are
+// untouched, so unaligned heads, partial tail lines and the memcpy() fallback for small copies are all covered.
+static void RunStreamCopyCorrectnessTests(uint8* src, uint8* dst, uint8* expected)
+{
+    for (uint32 i = 0; i < STREAM_COPY_TEST_SIZE; ++i)
+    {
+        src[i] = (uint8)RandomRange(0u, 256u);
+    }
+
+    for (uint32 iteration = 0; iteration < STREAM_COPY_TEST_ITERATIONS; ++iteration)
+    {
+        uint32 dst_offset = RandomRange(0u, STREAM_COPY_TEST_MAX_OFFSET);
+        uint32 src_offset = RandomRange(0u, CACHE_LINE_SIZE);
+        uint32 size       = RandomRange(0u, STREAM_COPY_TEST_MAX_COPY);
+        uint32 write_size = RandomRange(1u, STREAM_COPY_TEST_MAX_WRITE);
+        StreamCopyMethod method = iteration % 2 == 0 ? StreamCopyMethod::STREAM_COPY : StreamCopyMethod::STREAM_WRITER;
+
+        memset(dst,      0, STREAM_COPY_TEST_SIZE);
+        memset(expected, 0, STREAM_COPY_TEST_SIZE);
+        memcpy(&expected[dst_offset], &src[src_offset], size);
+        StreamCopyWithMethod(method, &dst[dst_offset], &src[src_offset], size, write_size);
+        if (memcmp(dst, expected, STREAM_COPY_TEST_SIZE) != 0)
+        {
+            CTK_FATAL("stream copy test failed: %s of %u bytes to offset %u doesn't match memcpy()",
+                      method == StreamCopyMethod::STREAM_COPY ? "StreamCopy()" : "StreamWrite()", size, dst_offset);
+        }
+    }
+}
+
+static float64 BenchmarkStreamCopy(StreamCopyMethod method, uint8* dst, uint8* src)
+{
+    uint64 start_ns = GetTimeNS();
+    for (uint32 iteration = 0; iteration < STREAM_COPY_BENCH_ITERATIONS; ++iteration)
+    {
+        StreamCopyWithMethod(method, dst, src, STREAM_COPY_BENCH_SIZE, STREAM_COPY_BENCH_WRITE_SIZE);
+    }
+    uint64 elapsed_ns = GetTimeNS() - start_ns;
+
+    // Bytes per nanosecond is GB/s.
+    return (float64)STREAM_COPY_BENCH_SIZE * STREAM_COPY_BENCH_ITERATIONS / (float64)Max(elapsed_ns, (uint64)1);
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+// Checks StreamCopy() and StreamWriter against memcpy(), then logs their throughput writing to mapped_buffer, which
+// must be host visible, at least STREAM_COPY_BENCH_SIZE bytes and not in use by the device.
+static void RunStreamCopyTests(BufferHnd mapped_buffer)
+{
+    if (GetBufferState(mapped_buffer)->size < STREAM_COPY_BENCH_SIZE)
+    {
+        CTK_FATAL("stream copy test failed: mapped buffer is smaller than benchmark size of %u",
+                  STREAM_COPY_BENCH_SIZE);
+    }
+
+    uint8* src      = Allocate<uint8>(&g_std_allocator, STREAM_COPY_BENCH_SIZE);
+    uint8* dst      = Allocate<uint8>(&g_std_allocator, STREAM_COPY_TEST_SIZE);
+    uint8* expected = Allocate<uint8>(&g_std_allocator, STREAM_COPY_TEST_SIZE);
+    RunStreamCopyCorrectnessTests(src, dst, expected);
+
+    // Warm up mapping and source before timing.
+    uint8* mapped = GetMappedMemory<uint8>(mapped_buffer, 0);
+    memset(src, 0xAB, STREAM_COPY_BENCH_SIZE);
+    StreamCopyWithMethod(StreamCopyMethod::MEMCPY, mapped, src, STREAM_COPY_BENCH_SIZE, STREAM_COPY_BENCH_WRITE_SIZE);
+
+    float64 memcpy_gbps        = BenchmarkStreamCopy(StreamCopyMethod::MEMCPY,        mapped, src);
+    float64 stream_copy_gbps   = BenchmarkStreamCopy(StreamCopyMethod::STREAM_COPY,   mapped, src);
+    float64 stream_writer_gbps = BenchmarkStreamCopy(StreamCopyMethod::STREAM_WRITER, mapped, src);
+    PrintLine("mapped memory writes (%u MB x %u):", STREAM_COPY_BENCH_SIZE / Megabyte32<1>(),
+              STREAM_COPY_BENCH_ITERATIONS);
+    PrintLine("    memcpy():                  %.2f GB/s", memcpy_gbps);
+    PrintLine("    StreamCopy():              %.2f GB/s", stream_copy_gbps);
+    PrintLine("    StreamWrite() (%3u bytes): %.2f GB/s", STREAM_COPY_BENCH_WRITE_SIZE, stream_writer_gbps);
+
+    Deallocate(&g_std_allocator, src);
+    Deallocate(&g_std_allocator, dst);
+    Deallocate(&g_std_allocator, expected);
+}
@@ -0,0 +1,118 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint32 UPLOAD_TEST_SLOT_WORDS = 4;
+static constexpr uint32 UPLOAD_TEST_SLOT_SIZE  = UPLOAD_TEST_SLOT_WORDS * sizeof(uint32);
+
+/// Utils
+////////////////////////////////////////////////////////////
+static uint64 GetUploadSemaphoreValue(VkSemaphore semaphore)
+{
+    uint64 value = 0;
+    VkResult res = vkGetSemaphoreCounterValue(GetDevice(), semaphore, &value);
+    Validate(res, "vkGetSemaphoreCounterValue() failed");
+
+    return value;
+}
+
+// Cycles through every upload slot several times, checking each ticket reads as pending until its timeline value is
+// signaled and as complete once it is.
+static void RunUploadTicketTests()
+{
+    uint32 upload_count = g_upload.uploads.size * 2 + 1;
+    for (uint32 i = 0; i < upload_count; ++i)
+    {
+        BeginUpload();
+        UploadTicket ticket = GetCurrentUpload()->ticket;
+        if (UploadComplete(ticket) || UploadsIdle())
+        {
+            CTK_FATAL("upload test failed: ticket %u reads as complete before being submitted", ticket.value);
+        }
+
+        UploadTicket submitted_ticket = SubmitUpload();
+        if (submitted_ticket.value != ticket.value)
+        {
+            CTK_FATAL("upload test failed: submitted ticket %u doesn't match recorded ticket %u",
+                      submitted_ticket.value, ticket.value);
+        }
+        bool signaled = GetUploadSemaphoreValue(g_upload.transfer_complete) >= ticket.value;
+        if (!signaled && UploadComplete(ticket))
+        {
+            CTK_FATAL("upload test failed: ticket %u reads as complete before its value was signaled", ticket.value);
+        }
+
+        WaitUpload(ticket);
+        if (GetUploadSemaphoreValue(g_upload.transfer_complete) < ticket.value)
+        {
+            CTK_FATAL("upload test failed: WaitUpload() returned before ticket %u was signaled", ticket.value);
+        }
+        if (!UploadComplete(ticket) || !UploadsIdle())
+        {
+            CTK_FATAL("upload test failed: ticket %u reads as pending after its value was signaled", ticket.value);
+        }
+    }
+}
+
+// Chains more copies than fit in the copy queue through one buffer, each copy reading the slot the previous copy wrote,
+// so slot values only arrive at the end of the chain intact if dependent copies are ordered within and across flushes.
+static void RunUploadCopyChainTests(Stack* perm_stack)
+{
+    uint32 copy_count = g_upload.buffer_copies.size + g_upload.buffer_copies.size / 2;
+    uint32 slot_count = copy_count + 1;
+
+    ResourceGroupInfo res_group_info = { .max_buffers = 1 };
+    ResourceGroupHnd res_group = CreateResourceGroup(perm_stack, &res_group_info);
+    BufferInfo buffer_info =
+    {
+        .size       = UPLOAD_TEST_SLOT_SIZE * slot_count,
+        .alignment  = USE_MIN_OFFSET_ALIGNMENT,
+        .per_frame  = false,
+        .flags      = 0,
+        .usage      = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    };
+    BufferHnd buffer = DefineBuffer(res_group, &buffer_info);
+    AllocateResourceGroup(res_group);
+
+    // Only the first slot has values; every other slot gets them from the chain.
+    auto words = GetMappedMemory<uint32>(buffer, 0);
+    memset(words, 0, UPLOAD_TEST_SLOT_SIZE * slot_count);
+    for (uint32 i = 0; i < UPLOAD_TEST_SLOT_WORDS; ++i)
+    {
+        words[i] = i + 1;
+    }
+
+    BeginUpload();
+    for (uint32 i = 0; i < copy_count; ++i)
+    {
+        DeviceBufferWrite write =
+        {
+            .size       = UPLOAD_TEST_SLOT_SIZE,
+            .src_hnd    = buffer,
+            .src_offset = UPLOAD_TEST_SLOT_SIZE * i,
+            .dst_hnd    = buffer,
+            .dst_offset = UPLOAD_TEST_SLOT_SIZE * (i + 1),
+        };
+        UploadBufferCmd(&write, 0);
+    }
+    WaitUpload(SubmitUpload());
+
+    for (uint32 slot_index = 1; slot_index < slot_count; ++slot_index)
+    for (uint32 i = 0; i < UPLOAD_TEST_SLOT_WORDS; ++i)
+    {
+        uint32 word = words[slot_index * UPLOAD_TEST_SLOT_WORDS + i];
+        if (word != i + 1)
+        {
+            CTK_FATAL("upload test failed: slot %u of %u-copy chain has word %u of %u instead of %u", slot_index,
+                      copy_count, i, word, i + 1);
+        }
+    }
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+// Must be called while no upload is pending.
+static void RunUploadTests(Stack* perm_stack)
+{
+    RunUploadTicketTests();
+    RunUploadCopyChainTests(perm_stack);
+}
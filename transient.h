@@ -0,0 +1,150 @@
+/// Data
+////////////////////////////////////////////////////////////
+struct TransientAllocatorInfo
+{
+    BufferHnd    buffer;     // Host visible per-frame buffer whose current frame range allocations are made from.
+    VkDeviceSize block_size; // Size of ranges threads claim at a time; larger allocations claim a range of their own.
+};
+
+struct TransientAllocation
+{
+    VkBuffer     buffer;
+    VkDeviceSize offset; // Offset in buffer, for binding or descriptor writes.
+    uint8*       mapped; // Host memory mapped to buffer at offset.
+};
+
+// Only the owning thread touches its block, so blocks are padded to avoid false sharing between render threads.
+struct alignas(64) TransientBlock
+{
+    VkDeviceSize offset; // Next free byte in buffer.
+    VkDeviceSize end;
+};
+
+struct TransientAllocator
+{
+    bool                      enabled;
+    BufferHnd                 buffer;
+    VkDeviceSize              block_size;
+    uint32                    thread_count; // Render threads + main thread.
+    std::atomic<VkDeviceSize> frame_used;   // Bytes claimed from current frame's range.
+    Array<TransientBlock>     blocks;       // size: thread_count
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static TransientAllocator g_transient_allocator;
+
+/// Utils
+////////////////////////////////////////////////////////////
+static void ClaimTransientBlock(TransientBlock* block, VkDeviceSize size)
+{
+    ResourceGroup* res_group = GetResourceGroup(g_transient_allocator.buffer.group_index);
+    VkDeviceSize frame_size = GetBufferInfo(res_group, g_transient_allocator.buffer.index)->size;
+    VkDeviceSize frame_offset =
+        GetBufferFrameState(res_group, g_transient_allocator.buffer.index, GetFrameIndex())->res_mem_offset;
+
+    // Blocks are claimed with a single atomic add, so threads never wait on each other.
+    VkDeviceSize claim_size = Max(g_transient_allocator.block_size, size);
+    VkDeviceSize start = g_transient_allocator.frame_used.fetch_add(claim_size);
+    if (start + claim_size > frame_size)
+    {
+        CTK_FATAL("can't allocate %u transient bytes: frame's %u-byte transient range is exhausted", size, frame_size);
+    }
+
+    block->offset = frame_offset + start;
+    block->end    = block->offset + claim_size;
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitTransientAllocator(Allocator* allocator, TransientAllocatorInfo* info)
+{
+    ResourceGroup* res_group = GetResourceGroup(info->buffer.group_index);
+    BufferState* buffer_state = GetBufferState(res_group, info->buffer.index);
+    if (buffer_state->frame_count != res_group->frame_count)
+    {
+        CTK_FATAL("can't init transient allocator: buffer must be per-frame");
+    }
+    if ((GetResourceMemory(res_group, buffer_state->res_mem_index)->properties &
+         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0)
+    {
+        CTK_FATAL("can't init transient allocator: buffer must be host visible");
+    }
+
+    g_transient_allocator.enabled      = true;
+    g_transient_allocator.buffer       = info->buffer;
+    g_transient_allocator.block_size   = info->block_size;
+    g_transient_allocator.thread_count = GetRenderThreadCount() + 1;
+    g_transient_allocator.frame_used   = 0;
+    g_transient_allocator.blocks       = CreateArrayFull<TransientBlock>(allocator, g_transient_allocator.thread_count);
+    CTK_ITER(block, &g_transient_allocator.blocks)
+    {
+        block->offset = 0;
+        block->end    = 0;
+    }
+}
+
+// Allocates from current frame's range. thread_index is render thread index, or GetRenderThreadCount() for main thread.
+static TransientAllocation AllocateTransient(VkDeviceSize size, VkDeviceSize alignment, uint32 thread_index)
+{
+    CTK_ASSERT(g_transient_allocator.enabled);
+    CTK_ASSERT(thread_index < g_transient_allocator.thread_count);
+
+    ResourceGroup* res_group = GetResourceGroup(g_transient_allocator.buffer.group_index);
+    uint32 buffer_index = g_transient_allocator.buffer.index;
+    if (alignment == USE_MIN_OFFSET_ALIGNMENT)
+    {
+        alignment = GetBufferState(res_group, buffer_index)->alignment;
+    }
+
+    // Bump allocate from thread's block, claiming a new block once it's full; worst-case padding is claimed so
+    // allocation is guaranteed to fit new block.
+    TransientBlock* block = GetPtr(&g_transient_allocator.blocks, thread_index);
+    VkDeviceSize offset = Align(block->offset, alignment);
+    if (offset + size > block->end)
+    {
+        ClaimTransientBlock(block, size + alignment - 1);
+        offset = Align(block->offset, alignment);
+    }
+    block->offset = offset + size;
+
+    return
+    {
+        .buffer = GetBuffer(res_group, buffer_index),
+        .offset = offset,
+        .mapped = &GetBufferMappedMemory(res_group, buffer_index)[offset],
+    };
+}
+
+// Marks current frame's claimed range written so it's flushed if buffer is non-coherent. Called by
+// SubmitRenderCommands().
+static void MarkTransientAllocationsWritten()
+{
+    if (!g_transient_allocator.enabled)
+    {
+        return;
+    }
+
+    ResourceGroup* res_group = GetResourceGroup(g_transient_allocator.buffer.group_index);
+    uint32 buffer_index = g_transient_allocator.buffer.index;
+    MarkBufferWritten(res_group, buffer_index,
+                      GetBufferFrameState(res_group, buffer_index, GetFrameIndex())->res_mem_offset,
+                      Min(g_transient_allocator.frame_used.load(), GetBufferInfo(res_group, buffer_index)->size));
+}
+
+// Releases all of current frame's allocations. Must only be called once the current frame's previous commands have
+// completed (see AcquireSwapchainImage()).
+static void ResetTransientAllocator()
+{
+    if (!g_transient_allocator.enabled)
+    {
+        return;
+    }
+
+    g_transient_allocator.frame_used = 0;
+    CTK_ITER(block, &g_transient_allocator.blocks)
+    {
+        block->offset = 0;
+        block->end    = 0;
+    }
+}
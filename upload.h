@@ -0,0 +1,524 @@
+/// Data
+////////////////////////////////////////////////////////////
+static constexpr uint32 DEFAULT_MAX_UPLOAD_BUFFER_COPIES = 1024;
+
+struct UploadTicket { uint64 value; };
+
+struct UploadModuleInfo
+{
+    uint32 max_pending_uploads;
+    uint32 max_buffer_copies; // Copies queued before being recorded; uses DEFAULT_MAX_UPLOAD_BUFFER_COPIES if 0.
+};
+
+struct Upload
+{
+    UploadTicket    ticket;
+    VkCommandBuffer transfer_command_buffer;
+    VkCommandBuffer graphics_command_buffer;
+    bool            graphics_commands_recorded;
+    bool            buffer_copies_recorded; // Later flushes must wait on writes of earlier ones.
+};
+
+struct UploadBufferCopy
+{
+    VkBuffer     src;
+    VkBuffer     dst;
+    VkBufferCopy region;
+};
+
+struct UploadModule
+{
+    VkCommandPool      transfer_command_pool;
+    VkCommandPool      graphics_command_pool;
+    VkSemaphore        transfer_complete; // Timeline semaphore signaled with ticket values by transfer submissions.
+    VkSemaphore        graphics_complete; // Timeline semaphore signaled with ticket values by graphics submissions.
+    RingBuffer<Upload> uploads;
+    uint64             next_ticket_value;
+    bool               recording;
+
+    // Buffer copies of the upload being recorded, recorded in batches by FlushUploadBufferCopies().
+    Array<UploadBufferCopy> buffer_copies;
+};
+
+/// Instance
+////////////////////////////////////////////////////////////
+static UploadModule g_upload;
+
+/// Forward Declarations
+////////////////////////////////////////////////////////////
+static bool RequiresOwnershipTransfer();
+
+/// Utils
+////////////////////////////////////////////////////////////
+static VkCommandPool CreateUploadCommandPool(VkDevice device, uint32 queue_family_index)
+{
+    VkCommandPoolCreateInfo info =
+    {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queue_family_index,
+    };
+    VkCommandPool command_pool = VK_NULL_HANDLE;
+    VkResult res = vkCreateCommandPool(device, &info, NULL, &command_pool);
+    Validate(res, "vkCreateCommandPool() failed");
+
+    return command_pool;
+}
+
+static VkCommandBuffer AllocateUploadCommandBuffer(VkDevice device, VkCommandPool command_pool)
+{
+    VkCommandBufferAllocateInfo allocate_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool        = command_pool,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1,
+    };
+    VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+    VkResult res = vkAllocateCommandBuffers(device, &allocate_info, &command_buffer);
+    Validate(res, "vkAllocateCommandBuffers() failed");
+
+    return command_buffer;
+}
+
+static void BeginUploadCommandBuffer(VkCommandBuffer command_buffer)
+{
+    VkCommandBufferBeginInfo info =
+    {
+        .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext            = NULL,
+        .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = NULL,
+    };
+    VkResult res = vkBeginCommandBuffer(command_buffer, &info);
+    Validate(res, "vkBeginCommandBuffer() failed");
+}
+
+static Upload* FindUpload(UploadTicket ticket)
+{
+    CTK_ASSERT(ticket.value < g_upload.next_ticket_value);
+    if (ticket.value == 0)
+    {
+        return NULL;
+    }
+
+    // Tickets start at 1 and are handed out in ring order, so ticket N is recorded into upload N - 1. Uploads are
+    // recycled once their ticket completes, so a ticket no longer owning its upload is complete.
+    Upload* upload = &g_upload.uploads.data[(ticket.value - 1) % g_upload.uploads.size];
+    return upload->ticket.value == ticket.value ? upload : NULL;
+}
+
+static int CompareUploadBufferCopies(const void* a, const void* b)
+{
+    auto copy_a = (UploadBufferCopy*)a;
+    auto copy_b = (UploadBufferCopy*)b;
+    if (copy_a->src != copy_b->src)
+    {
+        return copy_a->src < copy_b->src ? -1 : 1;
+    }
+    if (copy_a->dst != copy_b->dst)
+    {
+        return copy_a->dst < copy_b->dst ? -1 : 1;
+    }
+    if (copy_a->region.srcOffset != copy_b->region.srcOffset)
+    {
+        return copy_a->region.srcOffset < copy_b->region.srcOffset ? -1 : 1;
+    }
+    return 0;
+}
+
+// True if later copy reads or overwrites a range written by earlier copy, so it must be recorded after it.
+static bool DependsOnCopy(UploadBufferCopy* later, UploadBufferCopy* earlier)
+{
+    VkDeviceSize earlier_dst_end = earlier->region.dstOffset + earlier->region.size;
+    bool overwrites = later->dst == earlier->dst &&
+                      later->region.dstOffset < earlier_dst_end &&
+                      earlier->region.dstOffset < later->region.dstOffset + later->region.size;
+    bool reads      = later->src == earlier->dst &&
+                      later->region.srcOffset < earlier_dst_end &&
+                      earlier->region.dstOffset < later->region.srcOffset + later->region.size;
+    return overwrites || reads;
+}
+
+// Records a batch of independent copies with one vkCmdCopyBuffer() per source/destination buffer pair, merging regions
+// that are contiguous in both buffers (e.g. consecutive staging appends to consecutive sub-buffer ranges). Copies in a
+// batch never overlap, so they can be reordered freely.
+static void RecordUploadBufferCopyBatch(Upload* upload, UploadBufferCopy* copies, uint32 copy_count,
+                                        Array<VkBufferCopy>* regions, Array<VkBufferMemoryBarrier>* ownership_transfers)
+{
+    bool requires_ownership_transfer = RequiresOwnershipTransfer();
+    QueueFamilies* queue_families = &GetPhysicalDevice()->queue_families;
+
+    qsort(copies, copy_count, sizeof(UploadBufferCopy), CompareUploadBufferCopies);
+    regions->count = 0;
+    uint32 pair_start = 0;
+    for (uint32 i = 0; i < copy_count; ++i)
+    {
+        UploadBufferCopy* copy = &copies[i];
+
+        // Copies are sorted, so any region since pair_start is for the same buffer pair.
+        VkBufferCopy* prev_region = regions->count > pair_start ? GetPtr(regions, regions->count - 1) : NULL;
+        if (prev_region != NULL &&
+            prev_region->srcOffset + prev_region->size == copy->region.srcOffset &&
+            prev_region->dstOffset + prev_region->size == copy->region.dstOffset)
+        {
+            prev_region->size += copy->region.size;
+        }
+        else
+        {
+            Push(regions, copy->region);
+        }
+
+        UploadBufferCopy* next_copy = i + 1 < copy_count ? &copies[i + 1] : NULL;
+        if (next_copy != NULL && next_copy->src == copy->src && next_copy->dst == copy->dst)
+        {
+            continue;
+        }
+
+        vkCmdCopyBuffer(upload->transfer_command_buffer, copy->src, copy->dst, regions->count - pair_start,
+                        GetPtr(regions, pair_start));
+        if (requires_ownership_transfer)
+        {
+            for (uint32 region_index = pair_start; region_index < regions->count; ++region_index)
+            {
+                VkBufferCopy* region = GetPtr(regions, region_index);
+                Push(ownership_transfers,
+                {
+                    .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                    .pNext               = NULL,
+                    .srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT,
+                    .dstAccessMask       = VK_ACCESS_NONE,
+                    .srcQueueFamilyIndex = queue_families->transfer,
+                    .dstQueueFamilyIndex = queue_families->graphics,
+                    .buffer              = copy->dst,
+                    .offset              = region->dstOffset,
+                    .size                = region->size,
+                });
+            }
+        }
+        pair_start = regions->count;
+    }
+}
+
+// Records queued buffer copies in recording order batches. A copy that overwrites or reads a range written by an
+// earlier copy in the current batch starts a new batch, recorded after a barrier on the previous batch's writes, so
+// sorting and merging within batches never reorders dependent copies. Copies recorded by earlier flushes of the upload
+// aren't tracked, so a flush's first batch waits on their writes too.
+static void FlushUploadBufferCopies(Upload* upload)
+{
+    Array<UploadBufferCopy>* copies = &g_upload.buffer_copies;
+    if (copies->count == 0)
+    {
+        return;
+    }
+
+    CTK::Frame frame = CreateFrame();
+    auto regions             = CreateArray<VkBufferCopy>         (&frame, copies->count);
+    auto ownership_transfers = CreateArray<VkBufferMemoryBarrier>(&frame, copies->count);
+
+    uint32 batch_start = 0;
+    while (batch_start < copies->count)
+    {
+        uint32 batch_end = batch_start + 1;
+        for (; batch_end < copies->count; ++batch_end)
+        {
+            bool dependent = false;
+            for (uint32 i = batch_start; i < batch_end && !dependent; ++i)
+            {
+                dependent = DependsOnCopy(GetPtr(copies, batch_end), GetPtr(copies, i));
+            }
+            if (dependent)
+            {
+                break;
+            }
+        }
+
+        if (batch_start > 0 || upload->buffer_copies_recorded)
+        {
+            VkMemoryBarrier write_barrier =
+            {
+                .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .pNext         = NULL,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+            };
+            vkCmdPipelineBarrier(upload->transfer_command_buffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, // Source Stage Mask
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, // Destination Stage Mask
+                                 0,                              // Dependency Flags
+                                 1, &write_barrier,              // Memory Barriers
+                                 0, NULL,                        // Buffer Memory Barriers
+                                 0, NULL);                       // Image Memory Barriers
+        }
+        RecordUploadBufferCopyBatch(upload, GetPtr(copies, batch_start), batch_end - batch_start, &regions,
+                                    &ownership_transfers);
+        batch_start = batch_end;
+    }
+    copies->count = 0;
+    upload->buffer_copies_recorded = true;
+
+    if (ownership_transfers.count == 0)
+    {
+        return;
+    }
+
+    // Release written ranges from transfer queue family and acquire them on graphics queue family.
+    vkCmdPipelineBarrier(upload->transfer_command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,       // Source Stage Mask
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // Destination Stage Mask
+                         0,                                    // Dependency Flags
+                         0, NULL,                              // Memory Barriers
+                         ownership_transfers.count,            // Buffer Memory Barriers
+                         ownership_transfers.data,
+                         0, NULL);                             // Image Memory Barriers
+
+    CTK_ITER(ownership_transfer, &ownership_transfers)
+    {
+        ownership_transfer->srcAccessMask = VK_ACCESS_NONE;
+        ownership_transfer->dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    }
+    vkCmdPipelineBarrier(upload->graphics_command_buffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,     // Source Stage Mask
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, // Destination Stage Mask
+                         0,                                  // Dependency Flags
+                         0, NULL,                            // Memory Barriers
+                         ownership_transfers.count,          // Buffer Memory Barriers
+                         ownership_transfers.data,
+                         0, NULL);                           // Image Memory Barriers
+    upload->graphics_commands_recorded = true;
+}
+
+static VkSemaphore GetCompletionSemaphore(Upload* upload)
+{
+    // Uploads with graphics commands complete on the graphics queue after their transfer commands complete.
+    return upload->graphics_commands_recorded ? g_upload.graphics_complete : g_upload.transfer_complete;
+}
+
+/// Interface
+////////////////////////////////////////////////////////////
+static void InitUploadModule(Allocator* allocator, UploadModuleInfo info)
+{
+    CTK_ASSERT(info.max_pending_uploads > 0);
+
+    VkDevice device = GetDevice();
+    QueueFamilies* queue_families = &GetPhysicalDevice()->queue_families;
+
+    g_upload.transfer_command_pool = CreateUploadCommandPool(device, queue_families->transfer);
+    g_upload.graphics_command_pool = CreateUploadCommandPool(device, queue_families->graphics);
+    g_upload.transfer_complete     = CreateSemaphore(device, VK_SEMAPHORE_TYPE_TIMELINE);
+    g_upload.graphics_complete     = CreateSemaphore(device, VK_SEMAPHORE_TYPE_TIMELINE);
+    g_upload.uploads               = CreateRingBuffer<Upload>(allocator, info.max_pending_uploads);
+    CTK_ITER(upload, &g_upload.uploads)
+    {
+        upload->ticket                     = { .value = 0 };
+        upload->transfer_command_buffer    = AllocateUploadCommandBuffer(device, g_upload.transfer_command_pool);
+        upload->graphics_command_buffer    = AllocateUploadCommandBuffer(device, g_upload.graphics_command_pool);
+        upload->graphics_commands_recorded = false;
+        upload->buffer_copies_recorded     = false;
+    }
+
+    uint32 max_buffer_copies = info.max_buffer_copies > 0 ? info.max_buffer_copies : DEFAULT_MAX_UPLOAD_BUFFER_COPIES;
+    g_upload.buffer_copies = CreateArray<UploadBufferCopy>(allocator, max_buffer_copies);
+
+    // Ticket value 0 is never submitted, so it's always complete.
+    g_upload.next_ticket_value = 1;
+    g_upload.recording         = false;
+}
+
+static bool RequiresOwnershipTransfer()
+{
+    PhysicalDevice* physical_device = GetPhysicalDevice();
+    return physical_device->queue_families.transfer != physical_device->queue_families.graphics &&
+           physical_device->resource_sharing.mode == VK_SHARING_MODE_EXCLUSIVE;
+}
+
+static bool UploadComplete(UploadTicket ticket)
+{
+    Upload* upload = FindUpload(ticket);
+    if (upload == NULL)
+    {
+        return true;
+    }
+
+    uint64 value = 0;
+    VkResult res = vkGetSemaphoreCounterValue(GetDevice(), GetCompletionSemaphore(upload), &value);
+    Validate(res, "vkGetSemaphoreCounterValue() failed");
+
+    return value >= ticket.value;
+}
+
+static void WaitUpload(UploadTicket ticket)
+{
+    Upload* upload = FindUpload(ticket);
+    if (upload == NULL)
+    {
+        return;
+    }
+
+    VkSemaphore semaphore = GetCompletionSemaphore(upload);
+    VkSemaphoreWaitInfo wait_info =
+    {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .pNext          = NULL,
+        .flags          = 0,
+        .semaphoreCount = 1,
+        .pSemaphores    = &semaphore,
+        .pValues        = &ticket.value,
+    };
+    VkResult res = vkWaitSemaphores(GetDevice(), &wait_info, UINT64_MAX);
+    Validate(res, "vkWaitSemaphores() failed");
+}
+
+// True if no upload is being recorded and all submitted uploads have completed.
+static bool UploadsIdle()
+{
+    if (g_upload.recording)
+    {
+        return false;
+    }
+
+    // Uploads complete on different semaphores depending on whether they have graphics commands, so the last ticket
+    // completing doesn't imply earlier ones have.
+    for (uint32 i = 0; i < g_upload.uploads.size; ++i)
+    {
+        if (!UploadComplete(g_upload.uploads.data[i].ticket))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Upload* GetCurrentUpload()
+{
+    CTK_ASSERT(g_upload.recording);
+    return GetCurrentPtr(&g_upload.uploads);
+}
+
+static void BeginUpload()
+{
+    CTK_ASSERT(!g_upload.recording);
+
+    // Wait for previous upload using this upload's command buffers to complete before re-recording them.
+    Upload* upload = GetCurrentPtr(&g_upload.uploads);
+    WaitUpload(upload->ticket);
+
+    upload->ticket                     = { .value = g_upload.next_ticket_value };
+    upload->graphics_commands_recorded = false;
+    upload->buffer_copies_recorded     = false;
+    ++g_upload.next_ticket_value;
+    g_upload.recording = true;
+
+    BeginUploadCommandBuffer(upload->transfer_command_buffer);
+    BeginUploadCommandBuffer(upload->graphics_command_buffer);
+}
+
+// Copies are queued and recorded when the upload is submitted (or the queue fills), so uploads of many meshes and
+// buffers cost a handful of copy commands. They're recorded after commands recorded directly into the upload's command
+// buffers, e.g. by UploadImageCmd().
+static void UploadBufferCmd(DeviceBufferWrite* write, uint32 frame_index)
+{
+    Upload* upload = GetCurrentUpload();
+    ResourceGroup* res_group = GetResourceGroup(write->dst_hnd.group_index);
+    VkBufferCopy region = GetDeviceBufferWriteCopy(res_group, write, frame_index);
+
+    if (!CanPush(&g_upload.buffer_copies, 1))
+    {
+        FlushUploadBufferCopies(upload);
+    }
+    Push(&g_upload.buffer_copies,
+    {
+        .src    = GetBuffer(res_group, write->src_hnd.index),
+        .dst    = GetBuffer(res_group, write->dst_hnd.index),
+        .region = region,
+    });
+}
+
+static UploadTicket SubmitUpload()
+{
+    Upload* upload = GetCurrentUpload();
+    VkResult res = VK_SUCCESS;
+
+    // Submit transfer commands, signaling transfer completion with upload's ticket value. Staging writes to
+    // non-coherent memory are flushed first.
+    FlushUploadBufferCopies(upload);
+    res = vkEndCommandBuffer(upload->transfer_command_buffer);
+    Validate(res, "vkEndCommandBuffer() failed");
+    FlushHostWrites();
+    VkTimelineSemaphoreSubmitInfo transfer_timeline_info =
+    {
+        .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext                     = NULL,
+        .waitSemaphoreValueCount   = 0,
+        .pWaitSemaphoreValues      = NULL,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues    = &upload->ticket.value,
+    };
+    VkSubmitInfo transfer_submit_info =
+    {
+        .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext                = &transfer_timeline_info,
+        .waitSemaphoreCount   = 0,
+        .pWaitSemaphores      = NULL,
+        .pWaitDstStageMask    = NULL,
+        .commandBufferCount   = 1,
+        .pCommandBuffers      = &upload->transfer_command_buffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores    = &g_upload.transfer_complete,
+    };
+    res = vkQueueSubmit(GetTransferQueue(), 1, &transfer_submit_info, VK_NULL_HANDLE);
+    Validate(res, "vkQueueSubmit() failed");
+
+    // Submit graphics commands (ownership acquisition, mip generation, etc.) only if any were recorded, so pure
+    // buffer uploads never touch the graphics queue.
+    res = vkEndCommandBuffer(upload->graphics_command_buffer);
+    Validate(res, "vkEndCommandBuffer() failed");
+    if (upload->graphics_commands_recorded)
+    {
+        VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        VkTimelineSemaphoreSubmitInfo graphics_timeline_info =
+        {
+            .sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .pNext                     = NULL,
+            .waitSemaphoreValueCount   = 1,
+            .pWaitSemaphoreValues      = &upload->ticket.value,
+            .signalSemaphoreValueCount = 1,
+            .pSignalSemaphoreValues    = &upload->ticket.value,
+        };
+        VkSubmitInfo graphics_submit_info =
+        {
+            .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .pNext                = &graphics_timeline_info,
+            .waitSemaphoreCount   = 1,
+            .pWaitSemaphores      = &g_upload.transfer_complete,
+            .pWaitDstStageMask    = &wait_stage,
+            .commandBufferCount   = 1,
+            .pCommandBuffers      = &upload->graphics_command_buffer,
+            .signalSemaphoreCount = 1,
+            .pSignalSemaphores    = &g_upload.graphics_complete,
+        };
+        res = vkQueueSubmit(GetGraphicsQueue(), 1, &graphics_submit_info, VK_NULL_HANDLE);
+        Validate(res, "vkQueueSubmit() failed");
+    }
+
+    UploadTicket ticket = upload->ticket;
+    Next(&g_upload.uploads);
+    g_upload.recording = false;
+
+    return ticket;
+}
+
+// Submits commands recorded so far and continues recording into the next upload, e.g. once the staging ring is full.
+// Queues complete their submissions in order, so giving the continued upload graphics commands if the submitted part
+// had any makes the continued upload's ticket cover both parts. Likewise, the continued upload's copies wait on the
+// submitted part's copies.
+static void SplitUpload()
+{
+    Upload* upload = GetCurrentUpload();
+    bool graphics_commands_recorded = upload->graphics_commands_recorded;
+    bool buffer_copies_recorded     = upload->buffer_copies_recorded;
+    SubmitUpload();
+    BeginUpload();
+    GetCurrentUpload()->graphics_commands_recorded = graphics_commands_recorded;
+    GetCurrentUpload()->buffer_copies_recorded     = buffer_copies_recorded;
+}